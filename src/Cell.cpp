@@ -53,7 +53,8 @@ void Multiple_Value_Cell::set_values(std::vector<value_t> vs) {
 }
 
 value_t Multiple_Value_Cell::max_value() const {
-	return *std::max(_values.begin(), _values.end());
+	// (zero for a cell without values)
+	return _values.empty() ? 0 : *std::max_element(_values.begin(), _values.end());
 }
 
 std::ostream& sudoku_solver::operator<<(std::ostream& os, const Multiple_Value_Cell& c) {
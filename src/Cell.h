@@ -71,6 +71,7 @@ namespace sudoku_solver {
 		
 		bool is_empty() const {return _values.empty();}
 		void make_final() {_final = true;}
+		void make_non_final() {_final = false;}
 		bool is_final() const {return _final;}
 		void clear() {_values.clear();}
 		
@@ -0,0 +1,347 @@
+//
+//  Check.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Check.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include "Generate.h"
+#include "Hints.h"
+#include "Lockstep.h"
+#include "Portfolio.h"
+#include "Search.h"
+#include "Validate.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! kind of a generated grid
+	enum class Kind {unique, ambiguous, contradictory};
+
+	const char* to_string(Kind kind) {
+		switch (kind) {
+			case Kind::unique: return "unique";
+			case Kind::ambiguous: return "ambiguous";
+			case Kind::contradictory: return "contradictory";
+		}
+		return "unknown";
+	}
+
+	//! solves a block of grids of the same size (one result per grid)
+	using Solve_Block = std::function<std::vector<Solve_Result>(const std::vector<Single_Value_Sudoku_Grid>&)>;
+
+	struct Engine {
+		//! name without white space (as used in the baseline)
+		std::string name;
+		//! true if the engine counts up to two solutions
+		bool counts;
+		Solve_Block solve;
+	};
+
+	//! saved search and the layout read back from its checkpoint (which must outlive the search)
+	struct Resumed_Search {
+		std::unique_ptr<Grid_Layout> layout;
+		std::unique_ptr<Search_Engine> engine;
+	};
+
+	//! writes a checkpoint of the engine and resumes the search from it
+	//! @throws std::runtime_error if the checkpoint is rejected
+	Resumed_Search resume(const Search_Engine& engine, const Solve_Limits& limits, const Search_Options& options) {
+		std::stringstream checkpoint;
+		engine.save(checkpoint);
+		Resumed_Search resumed;
+		resumed.layout = Search_Engine::read_header(checkpoint);
+		resumed.engine.reset(new Search_Engine(checkpoint, *resumed.layout, limits, options));
+		return resumed;
+	}
+
+	//! counts the solutions of the empty grid until the search is deeper than the amount of cells (as far as
+	//! the search takes that long), resumes it from a checkpoint and continues both searches for a while
+	//! @return an empty string if both searches agree, otherwise the mismatch
+	std::string check_deep_checkpoint(unsigned int size) {
+
+		const Grid_Layout& layout = Grid_Layout::standard(size);
+		Search_Options options;
+		options.solution_limit = 0;
+		Search_Engine engine {create_possibility_grid(Single_Value_Sudoku_Grid {size}), layout, Solve_Limits(), options};
+		for (unsigned long slices = 0; engine.depth() <= layout.cells(); ++slices) {
+			if (engine.run(1) || slices == 1000000)
+				return "";
+		}
+
+		try {
+			Resumed_Search resumed = resume(engine, Solve_Limits(), options);
+			engine.run(1000);
+			resumed.engine->run(1000);
+			if (resumed.engine->depth() != engine.depth() || resumed.engine->stats().solutions != engine.stats().solutions)
+				return "resumed search at depth " + std::to_string(resumed.engine->depth()) + " with "
+					   + std::to_string(resumed.engine->stats().solutions) + " solutions instead of depth "
+					   + std::to_string(engine.depth()) + " with " + std::to_string(engine.stats().solutions);
+		} catch (const std::runtime_error& e) {
+			return std::string("resuming failed: ") + e.what();
+		}
+		return "";
+	}
+
+	//! @return all engines and configurations for grids of the given size
+	std::vector<Engine> engines(unsigned int size, const Solve_Limits& limits, std::uint64_t seed) {
+
+		const Grid_Layout& layout = Grid_Layout::standard(size);
+		auto one_by_one = [&layout, limits](const Search_Options& options) -> Solve_Block {
+			return [&layout, limits, options](const std::vector<Single_Value_Sudoku_Grid>& grids) {
+				std::vector<Solve_Result> results;
+				for (const Single_Value_Sudoku_Grid& sg : grids)
+					results.push_back(solve(sg, layout, limits, options));
+				return results;
+			};
+		};
+
+		std::vector<Engine> ret;
+		Search_Options counting;
+		counting.solution_limit = 2;
+		counting.seed = seed;
+		for (Branching b : {Branching::scan, Branching::random, Branching::degree, Branching::constraint}) {
+			Search_Options options = counting;
+			options.branching = b;
+			ret.push_back({to_string(b), true, one_by_one(options)});
+		}
+
+		Search_Options nogoods = counting;
+		nogoods.nogood_capacity = 65536;
+		ret.push_back({"nogoods", true, one_by_one(nogoods)});
+
+		Search_Options transpositions = counting;
+		transpositions.transposition_memory = std::size_t(16) << 20;
+		ret.push_back({"transpositions", true, one_by_one(transpositions)});
+
+		// restarts are disabled while counting
+		Search_Options restarts;
+		restarts.branching = Branching::random;
+		restarts.seed = seed;
+		restarts.restart_interval = 10;
+		restarts.nogood_capacity = 65536;
+		ret.push_back({"restarts", false, one_by_one(restarts)});
+
+		Search_Options sat = counting;
+		sat.backend = Backend::sat;
+		ret.push_back({"sat", true, one_by_one(sat)});
+
+		// the following engines search with nogoods as the plain search needs too long for a few grids
+		Search_Options learning;
+		learning.nogood_capacity = 65536;
+		learning.seed = seed;
+
+		auto cache = std::make_shared<Solution_Cache>(4096);
+		ret.push_back({"cache", false, [cache, limits, learning](const std::vector<Single_Value_Sudoku_Grid>& grids) {
+			std::vector<Solve_Result> results;
+			for (const Single_Value_Sudoku_Grid& sg : grids)
+				results.push_back(solve(sg, *cache, limits, learning));
+			return results;
+		}});
+
+		// the search is saved and resumed after every few assumptions
+		ret.push_back({"checkpoint", true, [&layout, limits, counting](const std::vector<Single_Value_Sudoku_Grid>& grids) {
+			std::vector<Solve_Result> results;
+			for (const Single_Value_Sudoku_Grid& sg : grids) {
+				Resumed_Search search;
+				search.engine.reset(new Search_Engine(create_possibility_grid(sg), layout, limits, counting));
+				try {
+					while (!search.engine->run(4))
+						search = resume(*search.engine, limits, counting);
+					results.push_back(search.engine->result());
+				} catch (const std::runtime_error& e) {
+					Solve_Result result;
+					result.status = Solve_Status::cancelled;
+					result.reason = std::string("resuming failed: ") + e.what();
+					results.push_back(std::move(result));
+				}
+			}
+			return results;
+		}});
+
+		// grids solved by propagation report their solution as well
+		Search_Options counting_learning = learning;
+		counting_learning.solution_limit = 2;
+
+		if (size == 9) {
+			ret.push_back({"lockstep", true, [limits, counting_learning](const std::vector<Single_Value_Sudoku_Grid>& grids) {
+				std::vector<Solve_Result> results;
+				for (std::size_t i = 0; i < grids.size(); i += lockstep_lanes) {
+					std::vector<Single_Value_Sudoku_Grid> block (grids.begin() + i,
+																 grids.begin() + std::min(i + lockstep_lanes, grids.size()));
+					for (Solve_Result& result : solve_lockstep(block, limits, counting_learning))
+						results.push_back(std::move(result));
+				}
+				return results;
+			}});
+		}
+
+		ret.push_back({"portfolio", false, [&layout, limits, learning](const std::vector<Single_Value_Sudoku_Grid>& grids) {
+			std::vector<Solve_Result> results;
+			for (const Single_Value_Sudoku_Grid& sg : grids)
+				results.push_back(solve_portfolio(sg, layout, portfolio(4, learning), limits));
+			return results;
+		}});
+
+		ret.push_back({"hints", false, [&layout, limits, learning](const std::vector<Single_Value_Sudoku_Grid>& grids) {
+			std::vector<Solve_Result> results;
+			for (const Single_Value_Sudoku_Grid& sg : grids) {
+				Hint_Solver solver {sg, layout};
+				Hint hint;
+				do {
+					hint = solver.step(true, limits, learning);
+				} while (hint.rule != Hint_Rule::solved && hint.rule != Hint_Rule::contradiction
+						 && hint.rule != Hint_Rule::interrupted);
+				Solve_Result result;
+				result.grid = solver.grid();
+				result.status = hint.rule == Hint_Rule::solved ? Solve_Status::solved
+							  : hint.rule == Hint_Rule::contradiction ? Solve_Status::contradiction : Solve_Status::timeout;
+				result.reason = to_string(hint.rule);
+				results.push_back(std::move(result));
+			}
+			return results;
+		}});
+
+		return ret;
+	}
+
+	//! @return an empty string if the result matches the grid and its kind, otherwise the mismatch
+	std::string verify(const Single_Value_Sudoku_Grid& sg, Kind kind, const Engine& engine,
+					   const Solve_Result& result, const Grid_Layout& layout) {
+
+		const unsigned int n = layout.size();
+		if (result.status != Solve_Status::solved && result.status != Solve_Status::contradiction)
+			return "interrupted (" + result.reason + ")";
+
+		const bool solvable = kind != Kind::contradictory;
+		if ((result.status == Solve_Status::solved) != solvable)
+			return std::string(solvable ? "no solution found" : "solution found") + " (" + result.reason + ")";
+
+		if (engine.counts) {
+			unsigned long expected = kind == Kind::unique ? 1 : kind == Kind::ambiguous ? 2 : 0;
+			if (std::min(result.stats.solutions, 2ul) != expected)
+				return std::to_string(result.stats.solutions) + " solutions found instead of " + std::to_string(expected);
+		}
+
+		if (result.status == Solve_Status::solved) {
+			Single_Value_Sudoku_Grid solution {n};
+			for (unsigned int x = 0; x < n; ++x) {
+				for (unsigned int y = 0; y < n; ++y) {
+					const Multiple_Value_Cell& cell = result.grid.get_cell(x, y);
+					if (cell.possibilities() != 1)
+						return "solution with an ambiguous cell";
+					solution.get_cell(x, y).set_value(cell.get_values()[0]);
+					const value_t given = sg.get_cell(x, y).get_value();
+					if (given != 0 && given != cell.get_values()[0])
+						return "solution changes a given";
+				}
+			}
+			if (!validate(solution, layout).solved())
+				return "invalid solution";
+		}
+		return "";
+	}
+
+}
+
+Check_Report sudoku_solver::check_engines(const Check_Options& options) {
+
+	Check_Report report;
+	std::mt19937_64 random {options.seed};
+
+	for (const Check_Size& check_size : options.sizes) {
+		const unsigned int size = check_size.size;
+		const Grid_Layout& layout = Grid_Layout::standard(size);
+
+		std::vector<Single_Value_Sudoku_Grid> grids;
+		std::vector<Kind> kinds;
+		for (unsigned long i = 0; i < options.grids; ++i) {
+			Single_Value_Sudoku_Grid solution = random_solution(size, random);
+			Single_Value_Sudoku_Grid unique = random_unique_puzzle(solution, check_size.givens, random);
+			grids.push_back(unique);
+			kinds.push_back(Kind::unique);
+			grids.push_back(random_ambiguous_puzzle(unique, random));
+			kinds.push_back(Kind::ambiguous);
+			grids.push_back(random_contradiction(unique, solution, i % 2 == 0, random));
+			kinds.push_back(Kind::contradictory);
+		}
+		report.grids += grids.size();
+
+		for (const Engine& engine : engines(size, options.limits, options.seed)) {
+			auto start = std::chrono::steady_clock::now();
+			std::vector<Solve_Result> results = engine.solve(grids);
+			auto time = std::chrono::steady_clock::now() - start;
+			report.timings.push_back({engine.name, size, std::chrono::duration_cast<std::chrono::microseconds>(time)});
+			report.runs += results.size();
+
+			for (std::size_t i = 0; i < grids.size(); ++i) {
+				std::string problem = verify(grids[i], kinds[i], engine, results[i], layout);
+				if (problem.empty())
+					continue;
+				std::ostringstream os;
+				os << engine.name << ": " << to_string(kinds[i]) << " " << size << "x" << size << " grid: " << problem
+				   << std::endl << grids[i];
+				report.failures.push_back(os.str());
+			}
+		}
+
+		std::string problem = check_deep_checkpoint(size);
+		++report.runs;
+		if (!problem.empty())
+			report.failures.push_back("checkpoint: empty " + std::to_string(size) + "x" + std::to_string(size)
+									  + " grid: " + problem);
+	}
+	return report;
+}
+
+std::vector<Check_Timing> sudoku_solver::read_timings(std::istream& is) {
+	std::vector<Check_Timing> timings;
+	std::string line;
+	while (std::getline(is, line)) {
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream ls {line};
+		Check_Timing t;
+		long long us = 0;
+		if (!(ls >> t.engine >> t.size >> us))
+			throw std::runtime_error("malformed timing: " + line);
+		t.time = std::chrono::microseconds(us);
+		timings.push_back(t);
+	}
+	return timings;
+}
+
+void sudoku_solver::write_timings(std::ostream& os, const std::vector<Check_Timing>& timings) {
+	os << "# engine size microseconds" << std::endl;
+	for (const Check_Timing& t : timings)
+		os << t.engine << " " << t.size << " " << t.time.count() << std::endl;
+}
+
+std::vector<std::string> sudoku_solver::timing_regressions(const std::vector<Check_Timing>& timings,
+														   const std::vector<Check_Timing>& baseline, double threshold) {
+	std::vector<std::string> regressions;
+	for (const Check_Timing& t : timings) {
+		for (const Check_Timing& b : baseline) {
+			if (t.engine != b.engine || t.size != b.size)
+				continue;
+			if (t.time.count() > b.time.count() * (1 + threshold) && t.time - b.time > std::chrono::milliseconds(1)) {
+				std::ostringstream os;
+				os << t.engine << " " << t.size << "x" << t.size << ": " << t.time.count() << "us (baseline "
+				   << b.time.count() << "us)";
+				regressions.push_back(os.str());
+			}
+		}
+	}
+	return regressions;
+}
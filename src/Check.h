@@ -0,0 +1,77 @@
+//
+//  Check.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Check_h
+#define Check_h
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "solve.h"
+
+namespace sudoku_solver {
+
+	//! size of generated grids and the fraction of the cells kept by their unique grids (as far as possible)
+	struct Check_Size {
+		unsigned int size;
+		double givens;
+	};
+
+	//! options of the differential check of all engines (see check_engines)
+	struct Check_Options {
+		//! larger grids keep more cells, so the slower engines still solve them within the limits
+		std::vector<Check_Size> sizes {{4, 0.3}, {9, 0.3}, {16, 0.5}};
+		//! amount of grids per size and kind (one solution, several solutions and none)
+		unsigned long grids = 10;
+		std::uint64_t seed = 0;
+		//! limits of each solving attempt (an interrupted attempt is a failure)
+		Solve_Limits limits;
+	};
+
+	//! time an engine needed for all grids of one size
+	struct Check_Timing {
+		std::string engine;
+		unsigned int size = 0;
+		std::chrono::microseconds time {0};
+	};
+
+	//! outcome of check_engines
+	struct Check_Report {
+		unsigned long grids = 0;
+		unsigned long runs = 0;
+		//! one message per wrong result (including the grid)
+		std::vector<std::string> failures;
+		std::vector<Check_Timing> timings;
+	};
+
+	//! generates random grids with one solution, with several solutions and without any (half of them with an
+	//! obvious conflict, half of them with a value which only contradicts the solution) and solves each of
+	//! them by every engine: the search in each branching order, with nogoods, transpositions and restarts,
+	//! the SAT backend, the search resumed from checkpoints, the solution cache, lockstep (9x9 only), the portfolio
+	//! and the hint solver. The count of the empty grid is also resumed once deeper than the amount of cells.
+	//! Solutions must be valid and keep the givens, all engines must agree with the kind of the grid on
+	//! solvability and the counting engines (up to two solutions) also on uniqueness.
+	Check_Report check_engines(const Check_Options& options);
+
+	//! reads timings in the format of write_timings (lines starting with '#' are skipped)
+	//! @throws std::runtime_error if a line is malformed
+	std::vector<Check_Timing> read_timings(std::istream& is);
+	//! writes one line per timing: engine, size and microseconds
+	void write_timings(std::ostream& os, const std::vector<Check_Timing>& timings);
+
+	//! @param threshold allowed slowdown as fraction of the baseline
+	//! @return a message per engine and size which took longer than its baseline by more than the threshold
+	//! and by more than a millisecond (timings without baseline are skipped)
+	std::vector<std::string> timing_regressions(const std::vector<Check_Timing>& timings,
+												const std::vector<Check_Timing>& baseline, double threshold);
+
+}
+
+#endif /* Check_h */
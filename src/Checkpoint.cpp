@@ -0,0 +1,333 @@
+//
+//  Checkpoint.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Checkpoint.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include "Search.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	const char magic[4] = {'S', 'U', 'D', 'K'};
+	const std::uint32_t version = 3;
+
+	template <class T>
+	void put(std::ostream& os, T value) {
+		std::uint64_t v = std::uint64_t(value);
+		char bytes[sizeof(T)];
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+			bytes[i] = char((v >> (8 * i)) & 0xff);
+		os.write(bytes, sizeof(T));
+	}
+
+	template <class T>
+	T get(std::istream& is) {
+		unsigned char bytes[sizeof(T)];
+		if (!is.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+			throw std::runtime_error("unexpected end of checkpoint");
+		std::uint64_t v = 0;
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+			v |= std::uint64_t(bytes[i]) << (8 * i);
+		return T(v);
+	}
+
+	//! @throws std::runtime_error if the value is larger than max
+	template <class T>
+	T get(std::istream& is, std::uint64_t max) {
+		T value = get<T>(is);
+		if (std::uint64_t(value) > max)
+			throw std::runtime_error("invalid checkpoint");
+		return value;
+	}
+
+	//! @throws std::runtime_error if the value is not between 1 and max
+	value_t get_value(std::istream& is, unsigned int max) {
+		value_t v = get<std::uint16_t>(is, max);
+		if (v == 0)
+			throw std::runtime_error("invalid value");
+		return v;
+	}
+
+}
+
+void sudoku_solver::write_grid(std::ostream& os, const Multiple_Value_Sudoku_Grid& g) {
+	put<std::uint32_t>(os, g.size());
+	for (unsigned int x = 0; x < g.size(); ++x) {
+		for (unsigned int y = 0; y < g.size(); ++y) {
+			const Multiple_Value_Cell& cell = g.get_cell(x, y);
+			put<std::uint8_t>(os, cell.is_final());
+			put<std::uint16_t>(os, cell.possibilities());
+			for (value_t v : cell.get_values())
+				put<std::uint16_t>(os, v);
+		}
+	}
+}
+
+Multiple_Value_Sudoku_Grid sudoku_solver::read_grid(std::istream& is) {
+	unsigned int size = get<std::uint32_t>(is, UINT16_MAX);
+	Multiple_Value_Sudoku_Grid g {size};
+	if (g.size() != size)
+		throw std::runtime_error("invalid grid size");
+	// values of the current cell
+	std::vector<bool> seen (size + 1, false);
+
+	for (unsigned int x = 0; x < size; ++x) {
+		for (unsigned int y = 0; y < size; ++y) {
+			Multiple_Value_Cell& cell = g.get_cell(x, y);
+			bool final = get<std::uint8_t>(is, 1);
+			std::uint16_t count = get<std::uint16_t>(is, size);
+			std::vector<value_t> values (count);
+			for (value_t& v : values) {
+				v = get_value(is, size);
+				if (seen[v])
+					throw std::runtime_error("value appears twice in a cell");
+				seen[v] = true;
+			}
+			for (value_t v : values)
+				seen[v] = false;
+			cell.set_values(std::move(values));
+			if (final)
+				cell.make_final();
+		}
+	}
+	return g;
+}
+
+void sudoku_solver::write_layout(std::ostream& os, const Grid_Layout& layout) {
+	put<std::uint32_t>(os, layout.size());
+	put<std::uint8_t>(os, layout.has_diagonals());
+	put<std::uint8_t>(os, layout.is_jigsaw());
+	if (layout.is_jigsaw()) {
+		for (unsigned int r : layout.regions())
+			put<std::uint16_t>(os, r);
+	}
+}
+
+std::unique_ptr<Grid_Layout> sudoku_solver::read_layout(std::istream& is) {
+	unsigned int size = get<std::uint32_t>(is, UINT16_MAX);
+	bool diagonals = get<std::uint8_t>(is, 1);
+	bool jigsaw = get<std::uint8_t>(is, 1);
+
+	try {
+		if (!jigsaw)
+			return std::unique_ptr<Grid_Layout>(new Grid_Layout(size, diagonals));
+
+		std::vector<unsigned int> regions (size * size);
+		for (unsigned int& r : regions)
+			r = get<std::uint16_t>(is);
+		return std::unique_ptr<Grid_Layout>(new Grid_Layout(size, regions, diagonals));
+	} catch (const std::invalid_argument& e) {
+		throw std::runtime_error(std::string("invalid layout: ") + e.what());
+	}
+}
+
+Checkpoint_Writer::~Checkpoint_Writer() {
+	wait();
+}
+
+bool Checkpoint_Writer::write(std::string data) {
+	if (_busy)
+		return false;
+	if (_thread.joinable())
+		_thread.join();
+
+	_busy = true;
+	_thread = std::thread([this](std::string data) {
+		std::string tmp_path = _path + ".tmp";
+		{
+			std::ofstream file {tmp_path, std::ios::binary | std::ios::trunc};
+			file.write(data.data(), std::streamsize(data.size()));
+			file.flush();
+			_failed = !file;
+		}
+		if (!_failed)
+			_failed = std::rename(tmp_path.c_str(), _path.c_str()) != 0;
+		_busy = false;
+	}, std::move(data));
+	return true;
+}
+
+bool Checkpoint_Writer::wait() {
+	if (_thread.joinable())
+		_thread.join();
+	return !_failed;
+}
+
+void Search_Engine::save(std::ostream& os) const {
+
+	os.write(magic, sizeof(magic));
+	put<std::uint32_t>(os, version);
+	write_layout(os, _layout);
+	write_grid(os, _grid);
+
+	put<std::uint64_t>(os, _stats.assumptions);
+	put<std::uint64_t>(os, _stats.propagation_rounds);
+	put<std::uint32_t>(os, _stats.max_depth);
+	put<std::uint64_t>(os, _stats.peak_memory);
+	put<std::uint64_t>(os, _stats.time.count());
+	put<std::uint64_t>(os, _stats.learned_nogoods);
+	put<std::uint64_t>(os, _stats.nogood_implications);
+	put<std::uint64_t>(os, _stats.transposition_hits);
+	put<std::uint64_t>(os, _stats.restarts);
+	put<std::uint64_t>(os, _restart_mark);
+	put<std::uint64_t>(os, _stats.solutions);
+	put<std::uint8_t>(os, bool(_solution));
+	if (_solution)
+		write_grid(os, *_solution);
+
+	put<std::uint8_t>(os, _started);
+	put<std::uint8_t>(os, _not_final);
+
+	for (const std::vector<value_t>& s : _sections) {
+		put<std::uint16_t>(os, s.size());
+		for (value_t v : s)
+			put<std::uint16_t>(os, v);
+	}
+
+	put<std::uint32_t>(os, _trail.size());
+	for (const Change& c : _trail) {
+		put<std::uint8_t>(os, c.kind);
+		put<std::uint32_t>(os, c.index);
+		put<std::uint16_t>(os, c.value);
+	}
+
+	put<std::uint32_t>(os, _stack.size());
+	for (const Choice& c : _stack) {
+		put<std::uint32_t>(os, c.trail_mark);
+		put<std::uint32_t>(os, c.cell);
+		put<std::uint16_t>(os, c.value);
+		put<std::uint32_t>(os, c.key);
+		put<std::uint32_t>(os, c.ordinal);
+		put<std::uint32_t>(os, c.choices);
+		put<std::uint64_t>(os, c.hash);
+		put<std::uint64_t>(os, c.assumptions);
+	}
+}
+
+std::unique_ptr<Grid_Layout> Search_Engine::read_header(std::istream& is) {
+	char m[sizeof(magic)];
+	if (!is.read(m, sizeof(m)) || !std::equal(m, m + sizeof(m), magic))
+		throw std::runtime_error("not a checkpoint");
+	if (get<std::uint32_t>(is) != version)
+		throw std::runtime_error("unsupported checkpoint version");
+	return read_layout(is);
+}
+
+Search_Engine::Search_Engine(std::istream& checkpoint, const Grid_Layout& layout,
+							 const Solve_Limits& limits, const Search_Options& options)
+: _layout(layout), _grid(read_grid(checkpoint)), _limits(limits)
+{
+	const unsigned int n = _layout.size();
+	if (_grid.size() != n)
+		throw std::runtime_error("grid does not match the layout");
+
+	_init(options);
+
+	_stats.assumptions = get<std::uint64_t>(checkpoint);
+	_stats.propagation_rounds = get<std::uint64_t>(checkpoint);
+	_stats.max_depth = get<std::uint32_t>(checkpoint);
+	_stats.peak_memory = get<std::uint64_t>(checkpoint);
+	_stats.time = std::chrono::microseconds(get<std::uint64_t>(checkpoint));
+	_stats.learned_nogoods = get<std::uint64_t>(checkpoint);
+	_stats.nogood_implications = get<std::uint64_t>(checkpoint);
+	_stats.transposition_hits = get<std::uint64_t>(checkpoint);
+	_stats.restarts = get<std::uint64_t>(checkpoint);
+	_restart_mark = get<std::uint64_t>(checkpoint, _stats.assumptions);
+	_stats.solutions = get<std::uint64_t>(checkpoint);
+	if (get<std::uint8_t>(checkpoint, 1)) {
+		_solution.reset(new Multiple_Value_Sudoku_Grid(read_grid(checkpoint)));
+		if (_solution->size() != n)
+			throw std::runtime_error("solution does not match the layout");
+	}
+	// the order of the assumptions depends on the amount of restarts
+	_shuffle();
+
+	_started = get<std::uint8_t>(checkpoint, 1);
+	_not_final = get<std::uint8_t>(checkpoint, 1);
+	// the time limit applies to the resumed part of the search
+	_deadline = std::chrono::steady_clock::now() + _limits.time;
+
+	for (std::vector<value_t>& s : _sections) {
+		s.resize(get<std::uint16_t>(checkpoint, n));
+		for (value_t& v : s)
+			v = get_value(checkpoint, n);
+	}
+
+	_trail.resize(get<std::uint32_t>(checkpoint, std::uint64_t(n) * n * n + 4 * n * n));
+	for (Change& c : _trail) {
+		c.kind = Change::Kind(get<std::uint8_t>(checkpoint, Change::used_value));
+		c.index = get<std::uint32_t>(checkpoint, c.kind == Change::used_value ? _layout.units() - 1 : _layout.cells() - 1);
+		// made_final has no value
+		c.value = c.kind == Change::made_final ? get<std::uint16_t>(checkpoint, 0) : get_value(checkpoint, n);
+	}
+
+	// the undo log must be revertible: replays the undo of all changes on the possible values, final flags
+	// and section sizes of the restored grid
+	{
+		std::vector<bool> possible (std::size_t(_layout.cells()) * n, false);
+		std::vector<bool> final (_layout.cells(), false);
+		for (cell_index_t c = 0; c < _layout.cells(); ++c) {
+			for (value_t v : _cells[c]->get_values())
+				possible[std::size_t(c) * n + v - 1] = true;
+			final[c] = _cells[c]->is_final();
+		}
+		std::vector<std::size_t> section_sizes;
+		for (const std::vector<value_t>& s : _sections)
+			section_sizes.push_back(s.size());
+
+		for (std::size_t i = _trail.size(); i-- > 0; ) {
+			const Change& c = _trail[i];
+			bool valid = false;
+			switch (c.kind) {
+				case Change::removed_value:
+					valid = !possible[std::size_t(c.index) * n + c.value - 1];
+					possible[std::size_t(c.index) * n + c.value - 1] = true;
+					break;
+				case Change::made_final:
+					valid = final[c.index];
+					final[c.index] = false;
+					break;
+				case Change::used_value:
+					valid = section_sizes[c.index] != 0 && _sections[c.index][section_sizes[c.index] - 1] == c.value;
+					if (valid)
+						--section_sizes[c.index];
+					break;
+			}
+			if (!valid)
+				throw std::runtime_error("undo log does not match the grid");
+		}
+	}
+
+	// each assumption removes one possible value, so there are at most as many choice points as values
+	_stack.resize(get<std::uint32_t>(checkpoint, std::uint64_t(_layout.cells()) * n));
+	std::uint32_t trail_mark = 0;
+	for (Choice& c : _stack) {
+		c.trail_mark = get<std::uint32_t>(checkpoint, _trail.size());
+		// the undo log of a choice point contains the ones of its parents
+		if (c.trail_mark < trail_mark)
+			throw std::runtime_error("decreasing undo log position");
+		trail_mark = c.trail_mark;
+		c.cell = get<std::uint32_t>(checkpoint, _layout.cells() - 1);
+		c.value = get<std::uint16_t>(checkpoint, n);
+		c.key = get<std::uint32_t>(checkpoint);
+		c.ordinal = get<std::uint32_t>(checkpoint);
+		// only the top choice point may be before its first assumption (without value)
+		if (c.value == 0 && (c.ordinal != 0 || &c != &_stack.back()))
+			throw std::runtime_error("choice point without assumption");
+		c.choices = get<std::uint32_t>(checkpoint);
+		c.hash = get<std::uint64_t>(checkpoint);
+		c.assumptions = get<std::uint64_t>(checkpoint);
+	}
+	if (_started && _stack.empty())
+		throw std::runtime_error("checkpoint of a finished search");
+}
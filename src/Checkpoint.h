@@ -0,0 +1,62 @@
+//
+//  Checkpoint.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Checkpoint_h
+#define Checkpoint_h
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "SudokuGrid.h"
+#include "Layout.h"
+
+namespace sudoku_solver {
+
+	// binary format of grids, layouts and search states (see Search_Engine::save)
+	// All integers are stored little endian with a fixed width. Reading functions throw std::runtime_error
+	// if the data is truncated or invalid.
+
+	//! writes the possible values and the final mark of each cell
+	void write_grid(std::ostream& os, const Multiple_Value_Sudoku_Grid& g);
+	Multiple_Value_Sudoku_Grid read_grid(std::istream& is);
+
+	//! writes the size, the diagonal flag and the regions of jigsaw layouts
+	void write_layout(std::ostream& os, const Grid_Layout& layout);
+	std::unique_ptr<Grid_Layout> read_layout(std::istream& is);
+
+	//! writes checkpoints to a file in the background
+	//! The data is written to a temporary file which replaces the checkpoint once complete,
+	//! so an interrupted write never destroys the previous checkpoint.
+	class Checkpoint_Writer {
+
+	public:
+		explicit Checkpoint_Writer(std::string path) : _path(std::move(path)) { }
+		Checkpoint_Writer(const Checkpoint_Writer&) = delete;
+		Checkpoint_Writer& operator=(const Checkpoint_Writer&) = delete;
+		//! waits for the last write
+		~Checkpoint_Writer();
+
+		//! starts writing the data unless the previous write is still in progress
+		//! @return false if the data was skipped
+		bool write(std::string data);
+		//! waits for the last write
+		//! @return false if the last write failed
+		bool wait();
+
+	private:
+		std::string _path;
+		std::thread _thread;
+		std::atomic<bool> _busy {false};
+		std::atomic<bool> _failed {false};
+	};
+
+}
+
+#endif /* Checkpoint_h */
@@ -0,0 +1,156 @@
+//
+//  Generate.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Generate.h"
+
+#include <algorithm>
+#include <math.h>
+#include <numeric>
+#include <vector>
+#include "solve.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! @return amount of solutions of the grid up to two
+	unsigned long solutions(const Single_Value_Sudoku_Grid& sg) {
+		Search_Options options;
+		options.solution_limit = 2;
+		options.nogood_capacity = 65536;
+		return solve(sg, Grid_Layout::standard(sg.size()), Solve_Limits(), options).stats.solutions;
+	}
+
+	//! @return the cells of the grid in random order
+	std::vector<unsigned int> shuffled_cells(unsigned int size, std::mt19937_64& random) {
+		std::vector<unsigned int> cells (size * size);
+		std::iota(cells.begin(), cells.end(), 0);
+		std::shuffle(cells.begin(), cells.end(), random);
+		return cells;
+	}
+
+	//! @return a random order of the lines: the bands (resp. stacks) and the lines within each of them are shuffled
+	std::vector<unsigned int> shuffled_lines(unsigned int box_size, std::mt19937_64& random) {
+		std::vector<unsigned int> bands (box_size);
+		std::iota(bands.begin(), bands.end(), 0);
+		std::shuffle(bands.begin(), bands.end(), random);
+
+		std::vector<unsigned int> lines;
+		std::vector<unsigned int> offsets (box_size);
+		for (unsigned int band : bands) {
+			std::iota(offsets.begin(), offsets.end(), 0);
+			std::shuffle(offsets.begin(), offsets.end(), random);
+			for (unsigned int offset : offsets)
+				lines.push_back(band * box_size + offset);
+		}
+		return lines;
+	}
+
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::random_solution(unsigned int size, std::mt19937_64& random) {
+
+	const unsigned int box_size = (unsigned int) sqrt(double(size));
+	std::vector<unsigned int> xs = shuffled_lines(box_size, random);
+	std::vector<unsigned int> ys = shuffled_lines(box_size, random);
+	std::vector<value_t> values (size);
+	std::iota(values.begin(), values.end(), 1);
+	std::shuffle(values.begin(), values.end(), random);
+
+	// the pattern shifts each line by one box resp. each band by one cell
+	Single_Value_Sudoku_Grid sg {size};
+	for (unsigned int x = 0; x < size; ++x) {
+		for (unsigned int y = 0; y < size; ++y) {
+			unsigned int px = xs[x], py = ys[y];
+			sg.get_cell(x, y).set_value(values[(box_size * (px % box_size) + px / box_size + py) % size]);
+		}
+	}
+	return sg;
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::random_puzzle(const Single_Value_Sudoku_Grid& solution, double givens,
+													  std::mt19937_64& random) {
+
+	const unsigned int n = solution.size();
+	std::vector<unsigned int> cells = shuffled_cells(n, random);
+
+	Single_Value_Sudoku_Grid sg {solution};
+	const std::size_t kept = std::size_t(givens * cells.size() + 0.5);
+	for (std::size_t i = kept; i < cells.size(); ++i)
+		sg.get_cell(cells[i] / n, cells[i] % n).set_value(0);
+	return sg;
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::random_unique_puzzle(const Single_Value_Sudoku_Grid& solution, double givens,
+															 std::mt19937_64& random) {
+
+	const unsigned int n = solution.size();
+	const std::size_t target = std::size_t(givens * n * n + 0.5);
+	std::size_t left = n * n;
+
+	Single_Value_Sudoku_Grid sg {solution};
+	for (unsigned int c : shuffled_cells(n, random)) {
+		if (left <= target)
+			break;
+		Single_Value_Cell& cell = sg.get_cell(c / n, c % n);
+		const value_t v = cell.get_value();
+		cell.set_value(0);
+		if (solutions(sg) == 1)
+			--left;
+		else
+			cell.set_value(v);
+	}
+	return sg;
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::random_ambiguous_puzzle(const Single_Value_Sudoku_Grid& sg_start,
+																std::mt19937_64& random) {
+
+	const unsigned int n = sg_start.size();
+	Single_Value_Sudoku_Grid sg {sg_start};
+	for (unsigned int c : shuffled_cells(n, random)) {
+		if (solutions(sg) > 1)
+			break;
+		sg.get_cell(c / n, c % n).set_value(0);
+	}
+	return sg;
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::random_contradiction(const Single_Value_Sudoku_Grid& unique,
+															 const Single_Value_Sudoku_Grid& solution, bool hidden,
+															 std::mt19937_64& random) {
+
+	const unsigned int n = unique.size();
+	const Grid_Layout& layout = Grid_Layout::standard(n);
+	Single_Value_Sudoku_Grid sg {unique};
+
+	for (unsigned int c : shuffled_cells(n, random)) {
+		if (sg.get_cell(c / n, c % n).get_value() != 0)
+			continue;
+
+		// values of the givens in the units of the cell
+		std::vector<bool> used (n + 1, false);
+		for (std::uint32_t i = 0; i < layout.peer_count(c); ++i) {
+			cell_index_t p = layout.peers(c)[i];
+			used[sg.get_cell(p / n, p % n).get_value()] = true;
+		}
+
+		std::vector<value_t> values;
+		for (value_t v = 1; v <= n; ++v) {
+			if (v != solution.get_cell(c / n, c % n).get_value() && used[v] != hidden)
+				values.push_back(v);
+		}
+		if (values.empty())
+			continue;
+		sg.get_cell(c / n, c % n).set_value(values[random() % values.size()]);
+		return sg;
+	}
+
+	// all other values of the empty cells appear in their units
+	return hidden ? random_contradiction(unique, solution, false, random) : sg;
+}
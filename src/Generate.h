@@ -0,0 +1,45 @@
+//
+//  Generate.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Generate_h
+#define Generate_h
+
+#include <random>
+#include "SudokuGrid.h"
+#include "Layout.h"
+
+namespace sudoku_solver {
+
+	//! @return a random solution of a standard grid of the given (square) size
+	//! (a pattern solution with shuffled values, lines within bands resp. stacks, bands and stacks)
+	Single_Value_Sudoku_Grid random_solution(unsigned int size, std::mt19937_64& random);
+
+	//! @return the grid with all cells but the given fraction (0 to 1) emptied, chosen at random
+	//! (the grid may have several solutions)
+	Single_Value_Sudoku_Grid random_puzzle(const Single_Value_Sudoku_Grid& solution, double givens,
+										   std::mt19937_64& random);
+
+	//! @return a grid with the given solution only: its cells are emptied in random order as long as the
+	//! solution stays unique, until only the given fraction (0 to 1) of the cells is left or no cell can be emptied
+	Single_Value_Sudoku_Grid random_unique_puzzle(const Single_Value_Sudoku_Grid& solution, double givens,
+												  std::mt19937_64& random);
+
+	//! @return the grid with further cells emptied (in random order) until it has several solutions
+	//! (the grid itself if it has several solutions already)
+	Single_Value_Sudoku_Grid random_ambiguous_puzzle(const Single_Value_Sudoku_Grid& sg, std::mt19937_64& random);
+
+	//! @return the unique grid with an empty cell set to a value which differs from the solution
+	//! @param hidden chooses a value which does not appear in the units of the cell (the grid has no solution but
+	//! no obvious conflict either), otherwise a given of a peer is repeated
+	Single_Value_Sudoku_Grid random_contradiction(const Single_Value_Sudoku_Grid& unique,
+												  const Single_Value_Sudoku_Grid& solution, bool hidden,
+												  std::mt19937_64& random);
+
+}
+
+#endif /* Generate_h */
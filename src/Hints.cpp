@@ -0,0 +1,363 @@
+//
+//  Hints.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Hints.h"
+
+#include <stdexcept>
+#include "Search.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	inline std::uint64_t bit(value_t v) {return std::uint64_t(1) << (v - 1);}
+	inline value_t lowest_value(std::uint64_t mask) {return value_t(__builtin_ctzll(mask) + 1);}
+	inline bool single(std::uint64_t mask) {return mask != 0 && (mask & (mask - 1)) == 0;}
+
+}
+
+const char* sudoku_solver::to_string(Hint_Rule rule) {
+	switch (rule) {
+		case Hint_Rule::naked_single: return "naked single";
+		case Hint_Rule::hidden_single: return "hidden single";
+		case Hint_Rule::pointing: return "pointing";
+		case Hint_Rule::assumption: return "assumption";
+		case Hint_Rule::contradiction: return "contradiction";
+		case Hint_Rule::interrupted: return "interrupted";
+		case Hint_Rule::solved: return "solved";
+	}
+	return "unknown";
+}
+
+Hint_Solver::Hint_Solver(const Single_Value_Sudoku_Grid& sg)
+: _layout(Grid_Layout::standard(sg.size()))
+{
+	_init(sg);
+}
+
+Hint_Solver::Hint_Solver(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout)
+: _layout(layout)
+{
+	_init(sg);
+}
+
+void Hint_Solver::_init(const Single_Value_Sudoku_Grid& sg) {
+
+	const unsigned int n = _layout.size();
+	if (n > 64)
+		throw std::invalid_argument("hints are supported up to size 64");
+	if (sg.size() != n)
+		throw std::invalid_argument("size of the grid does not match the layout");
+
+	_all = n == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+	_values.assign(_layout.cells(), 0);
+	_candidates.assign(_layout.cells(), _all);
+	_cancelled.assign(_layout.cells(), 0);
+	_counts.assign(_layout.units() * n, 0);
+	_used.assign(_layout.units(), 0);
+
+	for (unsigned int x = 0; x < n; ++x) {
+		for (unsigned int y = 0; y < n; ++y) {
+			if (!sg.get_cell(x, y).is_empty())
+				set_value(x * n + y, sg.get_cell(x, y).get_value());
+		}
+	}
+}
+
+bool Hint_Solver::set_value(cell_index_t c, value_t v) {
+
+	if (v == 0 || v > _layout.size())
+		throw std::out_of_range("value out of range");
+	if (_values[c] != 0)
+		clear_value(c);
+
+	const bool possible = _candidates[c] & bit(v);
+	const unsigned int n = _layout.size();
+
+	_values[c] = v;
+	_candidates[c] = bit(v);
+	++_placed;
+
+	// Ib.a: mark the value as used in all units of the cell
+	const std::uint32_t* units = _layout.cell_units(c);
+	for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i) {
+		std::uint8_t& count = _counts[units[i] * n + v - 1];
+		if (count++ == 1)
+			++_conflicts;
+		_used[units[i]] |= bit(v);
+	}
+
+	// and cancel it in the peers
+	const cell_index_t* peers = _layout.peers(c);
+	for (std::uint32_t i = 0; i < _layout.peer_count(c); ++i) {
+		if (_values[peers[i]] == 0)
+			_candidates[peers[i]] &= ~bit(v);
+	}
+
+	return possible;
+}
+
+void Hint_Solver::clear_value(cell_index_t c) {
+
+	const value_t v = _values[c];
+	if (v == 0)
+		return;
+
+	const unsigned int n = _layout.size();
+
+	_values[c] = 0;
+	--_placed;
+
+	const std::uint32_t* units = _layout.cell_units(c);
+	for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i) {
+		std::uint8_t& count = _counts[units[i] * n + v - 1];
+		if (--count == 1)
+			--_conflicts;
+		if (count == 0)
+			_used[units[i]] &= ~bit(v);
+	}
+
+	// values cancelled by pointing might depend on the removed value
+	for (cell_index_t d = 0; d < _layout.cells(); ++d) {
+		if (_cancelled[d] != 0) {
+			_cancelled[d] = 0;
+			if (_values[d] == 0)
+				_candidates[d] = _possible(d);
+		}
+	}
+
+	_candidates[c] = _possible(c);
+	const cell_index_t* peers = _layout.peers(c);
+	for (std::uint32_t i = 0; i < _layout.peer_count(c); ++i) {
+		if (_values[peers[i]] == 0)
+			_candidates[peers[i]] = _possible(peers[i]);
+	}
+}
+
+std::uint64_t Hint_Solver::_possible(cell_index_t c) const {
+	std::uint64_t possible = _all & ~_cancelled[c];
+	const std::uint32_t* units = _layout.cell_units(c);
+	for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i)
+		possible &= ~_used[units[i]];
+	return possible;
+}
+
+Hint Hint_Solver::step(bool apply, const Solve_Limits& limits, const Search_Options& options) {
+
+	Hint hint;
+
+	// a value placed twice in a unit
+	if (_conflicts != 0) {
+		const unsigned int n = _layout.size();
+		for (std::size_t i = 0; i < _counts.size(); ++i) {
+			if (_counts[i] > 1) {
+				hint.rule = Hint_Rule::contradiction;
+				hint.unit = std::uint32_t(i / n);
+				hint.value = value_t(i % n + 1);
+				return hint;
+			}
+		}
+	}
+
+	if (_placed == _layout.cells())
+		return hint;
+
+	// Ia.a: cells with one possible value left (or none)
+	bool found = false;
+	for (cell_index_t c = 0; c < _layout.cells(); ++c) {
+		if (_values[c] != 0)
+			continue;
+		if (_candidates[c] == 0) {
+			hint.rule = Hint_Rule::contradiction;
+			hint.cell = c;
+			return hint;
+		}
+		if (!found && single(_candidates[c])) {
+			hint.rule = Hint_Rule::naked_single;
+			hint.cell = c;
+			hint.value = lowest_value(_candidates[c]);
+			found = true;
+		}
+	}
+
+	if (!found && !_hidden_single(hint)) {
+		if (hint.rule == Hint_Rule::contradiction)
+			return hint;
+		if (_pointing(hint)) {
+			if (apply) {
+				_cancelled[hint.cell] |= bit(hint.value);
+				_candidates[hint.cell] &= ~bit(hint.value);
+			}
+			return hint;
+		}
+		hint = _assumption(limits, options);
+		if (hint.rule != Hint_Rule::assumption)
+			return hint;
+	}
+
+	if (apply)
+		set_value(hint.cell, hint.value);
+	return hint;
+}
+
+bool Hint_Solver::_hidden_single(Hint& hint) const {
+
+	const unsigned int n = _layout.size();
+
+	for (std::uint32_t u = 0; u < _layout.units(); ++u) {
+
+		const cell_index_t* cells = _layout.unit_cells(u);
+
+		// values possible in exactly one resp. more than one cell of the unit
+		std::uint64_t once = 0;
+		std::uint64_t twice = 0;
+		for (unsigned int k = 0; k < n; ++k) {
+			std::uint64_t m = _values[cells[k]] == 0 ? _candidates[cells[k]] : 0;
+			twice |= once & m;
+			once |= m;
+		}
+
+		std::uint64_t missing = _all & ~once & ~_used[u];
+		if (missing != 0) {
+			hint.rule = Hint_Rule::contradiction;
+			hint.unit = u;
+			hint.value = lowest_value(missing);
+			return false;
+		}
+
+		std::uint64_t hidden = once & ~twice;
+		if (hidden == 0)
+			continue;
+
+		value_t v = lowest_value(hidden);
+		for (unsigned int k = 0; k < n; ++k) {
+			if (_values[cells[k]] == 0 && (_candidates[cells[k]] & bit(v))) {
+				hint.rule = Hint_Rule::hidden_single;
+				hint.cell = cells[k];
+				hint.value = v;
+				hint.unit = u;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool Hint_Solver::_pointing(Hint& hint) const {
+
+	const unsigned int n = _layout.size();
+
+	for (std::uint32_t b = 0; b < _layout.units(); ++b) {
+
+		if (_layout.kind(b) != Unit_Kind::box && _layout.kind(b) != Unit_Kind::region)
+			continue;
+
+		const cell_index_t* box_cells = _layout.unit_cells(b);
+
+		for (value_t v = 1; v <= n; ++v) {
+
+			if (_used[b] & bit(v))
+				continue;
+
+			// cells of the box with the possible value v
+			cell_index_t first = 0;
+			unsigned int occurrences = 0;
+			for (unsigned int k = 0; k < n; ++k) {
+				if (_values[box_cells[k]] == 0 && (_candidates[box_cells[k]] & bit(v))) {
+					if (occurrences++ == 0)
+						first = box_cells[k];
+				}
+			}
+			if (occurrences < 2)
+				continue;
+
+			// other units of the first cell containing all of these cells
+			const std::uint32_t* units = _layout.cell_units(first);
+			for (std::uint32_t i = 0; i < _layout.cell_unit_count(first); ++i) {
+
+				std::uint32_t line = units[i];
+				if (line == b)
+					continue;
+
+				bool blocking = true;
+				for (unsigned int k = 0; blocking && k < n; ++k) {
+					if (_values[box_cells[k]] == 0 && (_candidates[box_cells[k]] & bit(v)))
+						blocking = _layout.contains(line, box_cells[k]);
+				}
+				if (!blocking)
+					continue;
+
+				const cell_index_t* line_cells = _layout.unit_cells(line);
+				for (unsigned int k = 0; k < n; ++k) {
+					cell_index_t c = line_cells[k];
+					if (_values[c] == 0 && (_candidates[c] & bit(v)) && !_layout.contains(b, c)) {
+						hint.rule = Hint_Rule::pointing;
+						hint.cell = c;
+						hint.value = v;
+						hint.unit = b;
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
+
+Hint Hint_Solver::_assumption(const Solve_Limits& limits, const Search_Options& options) {
+
+	Hint hint;
+	hint.rule = Hint_Rule::contradiction;
+
+	// the last solution is still valid if all of its values are possible
+	bool valid = !_solution.empty();
+	for (cell_index_t c = 0; valid && c < _layout.cells(); ++c)
+		valid = _candidates[c] & bit(_solution[c]);
+
+	if (!valid) {
+		_solution.clear();
+
+		Search_Engine engine {grid(), _layout, limits, options};
+		engine.run();
+		if (engine.status() != Solve_Status::solved) {
+			if (engine.status() != Solve_Status::contradiction)
+				hint.rule = Hint_Rule::interrupted;
+			return hint;
+		}
+
+		const unsigned int n = _layout.size();
+		for (cell_index_t c = 0; c < _layout.cells(); ++c)
+			_solution.push_back(engine.grid().get_cell(c / n, c % n).get_values()[0]);
+	}
+
+	// the value of the first empty cell
+	for (cell_index_t c = 0; c < _layout.cells(); ++c) {
+		if (_values[c] == 0) {
+			hint.rule = Hint_Rule::assumption;
+			hint.cell = c;
+			hint.value = _solution[c];
+			break;
+		}
+	}
+	return hint;
+}
+
+Multiple_Value_Sudoku_Grid Hint_Solver::grid() const {
+
+	const unsigned int n = _layout.size();
+	Multiple_Value_Sudoku_Grid mg {n};
+
+	for (cell_index_t c = 0; c < _layout.cells(); ++c) {
+		Multiple_Value_Cell& cell = mg.get_cell(c / n, c % n);
+		std::vector<value_t> values;
+		for (std::uint64_t m = _candidates[c]; m != 0; m &= m - 1)
+			values.push_back(lowest_value(m));
+		cell.set_values(std::move(values));
+	}
+	return mg;
+}
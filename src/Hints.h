@@ -0,0 +1,106 @@
+//
+//  Hints.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Hints_h
+#define Hints_h
+
+#include <cstdint>
+#include <vector>
+#include "solve.h"
+#include "Layout.h"
+
+namespace sudoku_solver {
+
+	//! rule of a deduction (see the synopsis in Search.cpp)
+	enum class Hint_Rule : std::uint8_t {
+		naked_single,	//!< Ia.a: the value is the only possible value of the cell
+		hidden_single,	//!< Ia.b: the cell is the only possible cell of the value in the unit
+		pointing,		//!< Ib.b: the value is confined to another unit inside the box (resp. region)
+		assumption,		//!< II: the value was found by assumptions
+		contradiction,	//!< the grid contains a contradiction (no deduction possible)
+		interrupted,	//!< the search for an assumption reached a limit (no deduction found)
+		solved			//!< all cells have a value
+	};
+
+	//! @return name of the rule (e.g. 'hidden single')
+	const char* to_string(Hint_Rule rule);
+
+	//! a single deduction
+	struct Hint {
+		Hint_Rule rule = Hint_Rule::solved;
+		//! the value is placed in the cell (resp. cancelled from the cell if the rule is pointing)
+		cell_index_t cell = 0;
+		value_t value = 0;
+		//! unit of a hidden single, box (resp. region) of a pointing value or unit of a contradiction
+		std::uint32_t unit = 0;
+	};
+
+	//! persistent state of possible values for interactive use
+	//! The possible values of all cells are kept as bit masks together with the placed values per unit,
+	//! so placing a value only updates the peers of its cell (Ib.a is applied immediately). step applies
+	//! the cheapest rule which leads to a deduction once.
+	class Hint_Solver {
+
+	public:
+		//! @throws std::invalid_argument if the size exceeds 64
+		Hint_Solver(const Single_Value_Sudoku_Grid& sg);
+		//! @param layout units of the grid (must outlive the solver)
+		Hint_Solver(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout);
+
+		//! finds the next deduction (trying naked singles, hidden singles, pointing values and assumptions in
+		//! this order) and applies it unless apply is false
+		//! (Deductions by assumptions are taken from one solution of ambiguous grids.)
+		//! @param limits, options limits and options of the search for deductions by assumptions
+		Hint step(bool apply = true, const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options());
+
+		//! places a value (user edit)
+		//! @return false if the value was not possible for the cell
+		bool set_value(cell_index_t c, value_t v);
+		//! removes a placed value (user edit)
+		//! (All values cancelled by pointing are possible again, as they might depend on the removed value.)
+		void clear_value(cell_index_t c);
+
+		//! @return placed value of the cell (zero if none)
+		value_t value(cell_index_t c) const {return _values[c];}
+		//! @return bit mask of the possible values of the cell (bit v - 1 for value v)
+		std::uint64_t candidates(cell_index_t c) const {return _candidates[c];}
+		bool solved() const {return _placed == _layout.cells() && _conflicts == 0;}
+
+		//! @return the possible values of all cells (in the form of create_possibility_grid)
+		Multiple_Value_Sudoku_Grid grid() const;
+
+	private:
+		const Grid_Layout& _layout;
+		std::uint64_t _all;
+		std::vector<value_t> _values;
+		std::vector<std::uint64_t> _candidates;
+		//! values cancelled by pointing per cell
+		std::vector<std::uint64_t> _cancelled;
+		//! amount of placed values per unit and value (unit * size + value - 1) and the resulting masks per unit
+		std::vector<std::uint8_t> _counts;
+		std::vector<std::uint64_t> _used;
+		//! amount of placed values resp. of values placed more than once in a unit
+		cell_index_t _placed = 0;
+		std::uint32_t _conflicts = 0;
+		//! solution found by the last search (reused as long as it matches the state)
+		std::vector<value_t> _solution;
+
+		void _init(const Single_Value_Sudoku_Grid& sg);
+		//! @return possible values of an empty cell due to the placed values and pointing
+		std::uint64_t _possible(cell_index_t c) const;
+		//! Ia.b and contradictions in units
+		bool _hidden_single(Hint& hint) const;
+		//! Ib.b
+		bool _pointing(Hint& hint) const;
+		//! II
+		Hint _assumption(const Solve_Limits& limits, const Search_Options& options);
+	};
+
+}
+
+#endif /* Hints_h */
@@ -0,0 +1,162 @@
+//
+//  Layout.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Layout.h"
+
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+using namespace sudoku_solver;
+
+const char* sudoku_solver::to_string(Unit_Kind kind) {
+	switch (kind) {
+		case Unit_Kind::line_x: return "vertical line";
+		case Unit_Kind::line_y: return "horizontal line";
+		case Unit_Kind::box: return "box";
+		case Unit_Kind::region: return "region";
+		case Unit_Kind::diagonal: return "diagonal";
+	}
+	return "unit";
+}
+
+const Grid_Layout& Grid_Layout::standard(unsigned int size, bool diagonals) {
+	static std::mutex mutex;
+	static std::map<std::pair<unsigned int, bool>, std::unique_ptr<Grid_Layout>> layouts;
+
+	std::lock_guard<std::mutex> lock {mutex};
+	std::unique_ptr<Grid_Layout>& layout = layouts[{size, diagonals}];
+	if (!layout)
+		layout.reset(new Grid_Layout(size, diagonals));
+	return *layout;
+}
+
+Grid_Layout::Grid_Layout(unsigned int size, bool diagonals)
+: _size(size), _standard(!diagonals), _diagonals(diagonals)
+{
+	unsigned int box_size = (unsigned int) (sqrt(double(size)));
+	if (size == 0)
+		throw std::invalid_argument("size of a layout must not be zero");
+	if (box_size * box_size != size)
+		throw std::invalid_argument("size of a layout with boxes must be a square");
+
+	// box index per cell (same as Sudoku_Grid::get_box_index)
+	std::vector<unsigned int> boxes (size * size);
+	for (unsigned int x = 0; x < size; ++x) {
+		for (unsigned int y = 0; y < size; ++y)
+			boxes[x * size + y] = (x / box_size) * box_size + y / box_size;
+	}
+
+	_build(boxes, Unit_Kind::box, diagonals);
+}
+
+Grid_Layout::Grid_Layout(unsigned int size, const std::vector<unsigned int>& regions, bool diagonals)
+: _size(size), _standard(false), _diagonals(diagonals)
+{
+	if (size == 0)
+		throw std::invalid_argument("size of a layout must not be zero");
+	if (regions.size() != size * size)
+		throw std::invalid_argument("amount of region indices must match the amount of cells");
+
+	_build(regions, Unit_Kind::region, diagonals);
+}
+
+bool Grid_Layout::contains(std::size_t unit, cell_index_t cell) const {
+	const std::uint32_t* units = cell_units(cell);
+	return std::find(units, units + cell_unit_count(cell), unit) != units + cell_unit_count(cell);
+}
+
+std::vector<unsigned int> Grid_Layout::regions() const {
+	std::vector<unsigned int> regions (cells());
+	for (unsigned int r = 0; r < _size; ++r) {
+		const cell_index_t* cells = unit_cells(2 * _size + r);
+		for (unsigned int k = 0; k < _size; ++k)
+			regions[cells[k]] = r;
+	}
+	return regions;
+}
+
+void Grid_Layout::_add_unit(Unit_Kind kind, const std::vector<cell_index_t>& cells) {
+	std::uint32_t unit = std::uint32_t(_kinds.size());
+	_kinds.push_back(kind);
+	for (cell_index_t c : cells) {
+		_unit_cells.push_back(c);
+		_cell_units[c * _units_per_cell + _cell_unit_count[c]++] = unit;
+	}
+}
+
+void Grid_Layout::_build(const std::vector<unsigned int>& regions, Unit_Kind region_kind, bool diagonals) {
+
+	const unsigned int n = _size;
+
+	_units_per_cell = diagonals ? 5 : 3;
+	_cell_units.assign(n * n * _units_per_cell, 0);
+	_cell_unit_count.assign(n * n, 0);
+	_unit_cells.reserve((diagonals ? 3 * n + 2 : 3 * n) * n);
+
+	std::vector<cell_index_t> cells;
+
+	// lines in x-direction (fixed x) and in y-direction (fixed y)
+	for (unsigned int x = 0; x < n; ++x) {
+		cells.clear();
+		for (unsigned int y = 0; y < n; ++y)
+			cells.push_back(x * n + y);
+		_add_unit(Unit_Kind::line_x, cells);
+	}
+	for (unsigned int y = 0; y < n; ++y) {
+		cells.clear();
+		for (unsigned int x = 0; x < n; ++x)
+			cells.push_back(x * n + y);
+		_add_unit(Unit_Kind::line_y, cells);
+	}
+
+	// boxes resp. regions
+	std::vector<std::vector<cell_index_t>> region_cells (n);
+	for (cell_index_t c = 0; c < n * n; ++c) {
+		if (regions[c] >= n)
+			throw std::invalid_argument("region index out of range");
+		region_cells[regions[c]].push_back(c);
+	}
+	for (auto& r : region_cells) {
+		if (r.size() != n)
+			throw std::invalid_argument("each region must contain exactly one cell per value");
+		_add_unit(region_kind, r);
+	}
+
+	// main and anti diagonal
+	if (diagonals) {
+		cells.clear();
+		for (unsigned int x = 0; x < n; ++x)
+			cells.push_back(x * n + x);
+		_add_unit(Unit_Kind::diagonal, cells);
+		cells.clear();
+		for (unsigned int x = 0; x < n; ++x)
+			cells.push_back(x * n + (n - 1 - x));
+		_add_unit(Unit_Kind::diagonal, cells);
+	}
+
+	// peers: all other cells of all units of a cell
+	_peer_offsets.assign(1, 0);
+	for (cell_index_t c = 0; c < n * n; ++c) {
+		cells.clear();
+		for (std::uint32_t i = 0; i < cell_unit_count(c); ++i) {
+			const cell_index_t* uc = unit_cells(cell_units(c)[i]);
+			for (unsigned int k = 0; k < n; ++k) {
+				if (uc[k] != c)
+					cells.push_back(uc[k]);
+			}
+		}
+		std::sort(cells.begin(), cells.end());
+		cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+		_peers.insert(_peers.end(), cells.begin(), cells.end());
+		_peer_offsets.push_back(std::uint32_t(_peers.size()));
+	}
+}
@@ -0,0 +1,90 @@
+//
+//  Layout.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Layout_h
+#define Layout_h
+
+#include <cstdint>
+#include <vector>
+
+namespace sudoku_solver {
+
+	//! index of a cell (x * size + y)
+	using cell_index_t = std::uint32_t;
+
+	//! kind of a unit (set of cells in which each value appears exactly once)
+	enum class Unit_Kind : std::uint8_t {line_x, line_y, box, region, diagonal};
+
+	//! @return name of the unit kind as used in contradiction messages (e.g. 'vertical line')
+	const char* to_string(Unit_Kind kind);
+
+	//! precomputed units and peers of all cells of a grid
+	//! All tables are stored as flat arrays. Every unit contains exactly size() cells.
+	//! Units are ordered by kind: lines in x-direction, lines in y-direction, boxes resp. regions and diagonals.
+	class Grid_Layout {
+
+	public:
+		//! @return the layout of a standard grid of the given size (built once per size and shared)
+		static const Grid_Layout& standard(unsigned int size, bool diagonals=false);
+
+		//! layout with lines, boxes and optionally both diagonals
+		//! @throws std::invalid_argument if the size is zero or not a square
+		Grid_Layout(unsigned int size, bool diagonals=false);
+		//! jigsaw layout with irregular regions instead of boxes and optionally both diagonals
+		//! @param regions index of the region (0 to size - 1) per cell index
+		//! @throws std::invalid_argument if the size is zero or a region does not contain exactly size cells
+		Grid_Layout(unsigned int size, const std::vector<unsigned int>& regions, bool diagonals=false);
+
+		unsigned int size() const {return _size;}
+		cell_index_t cells() const {return _size * _size;}
+		std::size_t units() const {return _kinds.size();}
+		//! @return true if the units are lines and (square) boxes only
+		bool is_standard() const {return _standard;}
+		bool has_diagonals() const {return _diagonals;}
+		//! @return true if the layout has irregular regions instead of boxes
+		bool is_jigsaw() const {return _kinds[2 * _size] == Unit_Kind::region;}
+		//! @return index of the box resp. region (0 to size - 1) per cell index
+		std::vector<unsigned int> regions() const;
+
+		Unit_Kind kind(std::size_t unit) const {return _kinds[unit];}
+		//! @return pointer to the size() cells of the unit
+		const cell_index_t* unit_cells(std::size_t unit) const {return &_unit_cells[unit * _size];}
+
+		//! @return pointer to the units containing the cell (see units_per_cell)
+		const std::uint32_t* cell_units(cell_index_t cell) const {return &_cell_units[cell * _units_per_cell];}
+		//! @return amount of units containing the cell
+		std::uint32_t cell_unit_count(cell_index_t cell) const {return _cell_unit_count[cell];}
+		//! @return true if the cell is a member of the unit
+		bool contains(std::size_t unit, cell_index_t cell) const;
+
+		//! @return pointer to all cells sharing a unit with the cell (see peer_count)
+		const cell_index_t* peers(cell_index_t cell) const {return &_peers[_peer_offsets[cell]];}
+		std::uint32_t peer_count(cell_index_t cell) const {return _peer_offsets[cell + 1] - _peer_offsets[cell];}
+
+	private:
+		unsigned int _size;
+		bool _standard;
+		bool _diagonals;
+		//! maximal amount of units per cell (lines, box resp. region and both diagonals)
+		std::uint32_t _units_per_cell;
+
+		std::vector<Unit_Kind> _kinds;
+		std::vector<cell_index_t> _unit_cells;
+		std::vector<std::uint32_t> _cell_units;
+		std::vector<std::uint32_t> _cell_unit_count;
+		std::vector<cell_index_t> _peers;
+		std::vector<std::uint32_t> _peer_offsets;
+
+		void _add_unit(Unit_Kind kind, const std::vector<cell_index_t>& cells);
+		//! builds the lines, the boxes resp. regions and the diagonals
+		void _build(const std::vector<unsigned int>& regions, Unit_Kind region_kind, bool diagonals);
+	};
+
+}
+
+#endif /* Layout_h */
@@ -0,0 +1,195 @@
+//
+//  Lockstep.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Lockstep.h"
+
+#include <cstdint>
+#include "Layout.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	const unsigned int size = 9;
+	const unsigned int cells = size * size;
+	const unsigned int units = 3 * size;
+
+	//! bit v - 1 is set if the value v is possible, one lane per grid (GCC vector extension)
+	typedef std::uint16_t lanes_t __attribute__((vector_size(2 * lockstep_lanes)));
+
+	//! @return the mask with all bits set in the lanes which have at most one bit set
+	//! (a macro since vector arguments and return values depend on the enabled instruction set)
+	#define at_most_one(m) ((lanes_t) (((m) & ((m) - 1)) == 0))
+
+	//! propagates a block of grids until none of them changes anymore
+	//! @param rounds receives the amount of propagation rounds per lane
+	//! @param bad receives a nonzero mask for the lanes containing a contradiction
+	void propagate(lanes_t (&grid)[cells], unsigned long (&rounds)[lockstep_lanes], lanes_t& bad) {
+
+		const Grid_Layout& layout = Grid_Layout::standard(size);
+		const lanes_t all_values = (lanes_t) {} + ((1 << size) - 1);
+
+		bad = (lanes_t) {};
+
+		bool active = true;
+		while (active) {
+
+			lanes_t changed = {};
+
+			for (std::uint32_t u = 0; u < units; ++u) {
+
+				const cell_index_t* unit_cells = layout.unit_cells(u);
+
+				// Ia.a: values of cells with one possible value left (used values of the unit)
+				lanes_t used = {};
+				for (unsigned int k = 0; k < size; ++k) {
+					lanes_t m = grid[unit_cells[k]];
+					lanes_t single = m & at_most_one(m);
+					bad |= used & single;
+					used |= single;
+				}
+
+				// Ib.a: cancel used values from all other cells of the unit
+				for (unsigned int k = 0; k < size; ++k) {
+					lanes_t m = grid[unit_cells[k]];
+					lanes_t reduced = m & ~(used & ~at_most_one(m));
+					changed |= reduced ^ m;
+					grid[unit_cells[k]] = reduced;
+				}
+
+				// Ia.b: values with a single occurrence in the unit
+				lanes_t once = {};
+				lanes_t twice = {};
+				for (unsigned int k = 0; k < size; ++k) {
+					lanes_t m = grid[unit_cells[k]];
+					twice |= once & m;
+					once |= m;
+				}
+				// a value without any possible cell is a contradiction
+				bad |= all_values & ~once;
+
+				lanes_t hidden = once & ~twice;
+				for (unsigned int k = 0; k < size; ++k) {
+					lanes_t m = grid[unit_cells[k]];
+					lanes_t h = m & hidden;
+					// two values occurring once in the same cell are a contradiction
+					bad |= h & ~at_most_one(h);
+					lanes_t is_hidden = (lanes_t) (h != 0);
+					lanes_t reduced = (h & is_hidden) | (m & ~is_hidden);
+					changed |= reduced ^ m;
+					grid[unit_cells[k]] = reduced;
+				}
+			}
+
+			// a cell without possible values is a contradiction
+			for (unsigned int c = 0; c < cells; ++c)
+				bad |= (lanes_t) (grid[c] == 0);
+
+			// continue as long as one lane without contradiction changes
+			active = false;
+			for (unsigned int l = 0; l < lockstep_lanes; ++l) {
+				if (changed[l] != 0 && bad[l] == 0) {
+					++rounds[l];
+					active = true;
+				}
+			}
+		}
+	}
+
+	#undef at_most_one
+
+}
+
+std::vector<Solve_Result> sudoku_solver::solve_lockstep(const std::vector<Single_Value_Sudoku_Grid>& grids,
+														const Solve_Limits& limits,
+														const Search_Options& options,
+														Solution_Cache* cache) {
+
+	std::vector<Solve_Result> results (grids.size());
+
+	// the grids solved one by one
+	auto solve_single = [&](std::size_t i) {
+		if (cache && grids[i].size() == size)
+			results[i] = solve(grids[i], *cache, limits, options);
+		else
+			results[i] = solve(grids[i], Grid_Layout::standard(grids[i].size()), limits, options);
+	};
+
+	// indices of the 9x9 grids of the current block
+	std::vector<std::size_t> block;
+	block.reserve(lockstep_lanes);
+
+	std::size_t next = 0;
+	while (next < grids.size()) {
+
+		block.clear();
+		for (; next < grids.size() && block.size() < lockstep_lanes; ++next) {
+			if (grids[next].size() == size)
+				block.push_back(next);
+			else
+				solve_single(next);
+		}
+		if (block.empty())
+			continue;
+
+		auto start = std::chrono::steady_clock::now();
+
+		// unused lanes keep all values possible (they never change)
+		lanes_t grid[cells];
+		for (unsigned int c = 0; c < cells; ++c)
+			grid[c] = (lanes_t) {} + ((1 << size) - 1);
+		for (unsigned int l = 0; l < block.size(); ++l) {
+			const Single_Value_Sudoku_Grid& sg = grids[block[l]];
+			for (unsigned int x = 0; x < size; ++x) {
+				for (unsigned int y = 0; y < size; ++y) {
+					value_t v = sg.get_cell(x, y).get_value();
+					if (v != 0)
+						grid[x * size + y][l] = std::uint16_t(1 << (v - 1));
+				}
+			}
+		}
+
+		unsigned long rounds[lockstep_lanes] = {};
+		lanes_t bad;
+		propagate(grid, rounds, bad);
+
+		auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+		for (unsigned int l = 0; l < block.size(); ++l) {
+
+			bool solved = bad[l] == 0;
+			for (unsigned int c = 0; solved && c < cells; ++c)
+				solved = (grid[c][l] & (grid[c][l] - 1)) == 0;
+
+			// drop out to the single grid engine
+			if (!solved) {
+				solve_single(block[l]);
+				continue;
+			}
+
+			Solve_Result& result = results[block[l]];
+			result.grid = Multiple_Value_Sudoku_Grid(size);
+			for (unsigned int x = 0; x < size; ++x) {
+				for (unsigned int y = 0; y < size; ++y) {
+					Multiple_Value_Cell& cell = result.grid.get_cell(x, y);
+					cell = Multiple_Value_Cell(value_t(__builtin_ctz(grid[x * size + y][l]) + 1));
+					cell.make_final();
+				}
+			}
+			result.status = Solve_Status::solved;
+			result.reason = "solved";
+			// the last round confirms that nothing changes anymore
+			result.stats.propagation_rounds = rounds[l] + 1;
+			result.stats.time = time / block.size();
+			// a grid solved by propagation alone has no other solution
+			result.stats.solutions = 1;
+		}
+	}
+
+	return results;
+}
@@ -0,0 +1,33 @@
+//
+//  Lockstep.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Lockstep_h
+#define Lockstep_h
+
+#include <vector>
+#include "solve.h"
+
+namespace sudoku_solver {
+
+	//! amount of 9x9 grids propagated at once (one per SIMD lane)
+	const unsigned int lockstep_lanes = 16;
+
+	//! solves many standard 9x9 grids
+	//! Blocks of lockstep_lanes grids are stored as bit masks of possible values with one SIMD lane per grid
+	//! and step Ia.a (naked singles), Ia.b (hidden singles) and Ib.a (elimination) are applied to all of them
+	//! at once. Grids which are not solved by these rules (they need step Ib.b or II or contain a contradiction)
+	//! as well as grids of other sizes are solved one by one via solve (using the cache if one is given).
+	//! @return one result per grid (in the same order)
+	std::vector<Solve_Result> solve_lockstep(const std::vector<Single_Value_Sudoku_Grid>& grids,
+											 const Solve_Limits& limits = Solve_Limits(),
+											 const Search_Options& options = Search_Options(),
+											 Solution_Cache* cache = nullptr);
+
+}
+
+#endif /* Lockstep_h */
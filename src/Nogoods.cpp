@@ -0,0 +1,42 @@
+//
+//  Nogoods.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Nogoods.h"
+
+using namespace sudoku_solver;
+
+Nogood_Store::Nogood_Store(std::size_t literals, std::size_t capacity, unsigned int max_size)
+: _capacity(capacity), _max_size(max_size < 2 ? 2 : (max_size > 255 ? 255 : max_size)),
+  _literals(capacity * _max_size), _sizes(capacity, 0), _watches(literals)
+{ }
+
+bool Nogood_Store::add(const std::vector<literal_t>& literals) {
+
+	// nogoods with a single literal are facts which need no store
+	if (_capacity == 0 || literals.size() < 2 || literals.size() > _max_size)
+		return false;
+
+	std::size_t slot = _next;
+	_next = (_next + 1) % _capacity;
+	if (_count < _capacity)
+		++_count;
+
+	// watch the last (not true) and the second to last literal
+	literal_t* lits = &_literals[slot * _max_size];
+	std::size_t size = literals.size();
+	lits[0] = literals[size - 1];
+	lits[1] = literals[size - 2];
+	for (std::size_t k = 0; k + 2 < size; ++k)
+		lits[k + 2] = literals[k];
+	_sizes[slot] = std::uint8_t(size);
+
+	// watches of a replaced nogood are dropped lazily
+	_watches[lits[0]].push_back(std::uint32_t(slot));
+	_watches[lits[1]].push_back(std::uint32_t(slot));
+	return true;
+}
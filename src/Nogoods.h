@@ -0,0 +1,110 @@
+//
+//  Nogoods.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Nogoods_h
+#define Nogoods_h
+
+#include <cstdint>
+#include <vector>
+
+namespace sudoku_solver {
+
+	//! bounded store of nogoods learned from contradictions in step II
+	//! A nogood is a small set of literals which cannot be true all at once. A literal (cell * size + value - 1)
+	//! is true if the value is no longer possible for the cell.
+	//! Each nogood watches two of its literals which are not true. Only when a watched literal becomes true
+	//! the nogood is visited (watches are kept on backtracking). Once full, the oldest nogood is replaced.
+	class Nogood_Store {
+
+	public:
+		using literal_t = std::uint32_t;
+
+		//! @param literals amount of different literals (cells * size)
+		//! @param capacity maximal amount of nogoods
+		//! @param max_size maximal amount of literals per nogood
+		Nogood_Store(std::size_t literals, std::size_t capacity, unsigned int max_size);
+
+		//! stores a nogood whose literals are all true except the last one
+		//! (The last and the second to last literal are watched.)
+		//! @return false if the nogood has too many literals
+		bool add(const std::vector<literal_t>& literals);
+
+		//! visits the nogoods watching a literal which just became true
+		//! @param is_true predicate telling whether a literal is true
+		//! @param implied receives the literals which cannot become true anymore
+		//! @return false if all literals of a nogood are true (contradiction)
+		template <class Pred>
+		bool propagate(literal_t l, const Pred& is_true, std::vector<literal_t>& implied);
+
+		std::size_t size() const {return _count;}
+		std::size_t capacity() const {return _capacity;}
+		unsigned int max_size() const {return _max_size;}
+
+	private:
+		std::size_t _capacity;
+		unsigned int _max_size;
+		std::size_t _count = 0;
+		//! slot for the next nogood (oldest one if full)
+		std::size_t _next = 0;
+
+		//! literals per slot (max_size each, the watched ones first)
+		std::vector<literal_t> _literals;
+		std::vector<std::uint8_t> _sizes;
+		//! slots watching a literal per literal
+		std::vector<std::vector<std::uint32_t>> _watches;
+	};
+
+	template <class Pred>
+	bool Nogood_Store::propagate(literal_t l, const Pred& is_true, std::vector<literal_t>& implied) {
+
+		std::vector<std::uint32_t>& watches = _watches[l];
+
+		for (std::size_t i = 0; i < watches.size(); ) {
+
+			std::uint32_t slot = watches[i];
+			literal_t* lits = &_literals[slot * _max_size];
+			unsigned int size = _sizes[slot];
+
+			// drop watches of replaced nogoods
+			if (size == 0 || (lits[0] != l && lits[1] != l)) {
+				watches[i] = watches.back();
+				watches.pop_back();
+				continue;
+			}
+
+			// the watched literal which became true is kept at position 1
+			if (lits[0] == l)
+				std::swap(lits[0], lits[1]);
+
+			// try to watch another literal which is not true
+			bool moved = false;
+			for (unsigned int k = 2; k < size; ++k) {
+				if (!is_true(lits[k])) {
+					std::swap(lits[1], lits[k]);
+					_watches[lits[1]].push_back(slot);
+					watches[i] = watches.back();
+					watches.pop_back();
+					moved = true;
+					break;
+				}
+			}
+			if (moved)
+				continue;
+
+			// all literals except the other watched one are true
+			if (is_true(lits[0]))
+				return false;
+			implied.push_back(lits[0]);
+			++i;
+		}
+		return true;
+	}
+
+}
+
+#endif /* Nogoods_h */
@@ -0,0 +1,308 @@
+//
+//  Packed.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Packed.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Layout.h"
+#include "SolutionCache.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	const char magic[4] = {'S', 'D', 'K', 'P'};
+	const std::size_t header_bytes = 16;
+
+	void write_header(std::uint8_t* header, unsigned int size, bool with_status, std::uint64_t count) {
+		std::memcpy(header, magic, sizeof(magic));
+		header[4] = std::uint8_t(size);
+		header[5] = std::uint8_t(size >> 8);
+		header[6] = std::uint8_t(packed_bits(size));
+		header[7] = with_status ? packed_with_status : 0;
+		for (unsigned int i = 0; i < 8; ++i)
+			header[8 + i] = std::uint8_t(count >> (8 * i));
+	}
+
+	std::runtime_error system_error(const std::string& what, const std::string& path) {
+		return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+	}
+
+}
+
+unsigned int sudoku_solver::packed_bits(unsigned int size) {
+	unsigned int bits = 1;
+	while ((1u << bits) < size + 1)
+		++bits;
+	return bits;
+}
+
+std::size_t sudoku_solver::packed_grid_bytes(unsigned int size, bool with_status) {
+	return (std::size_t(size) * size * packed_bits(size) + 7) / 8 + (with_status ? 1 : 0);
+}
+
+void sudoku_solver::pack(const Single_Value_Sudoku_Grid& sg, std::uint8_t* bytes) {
+	const unsigned int bits = packed_bits(sg.size());
+	std::memset(bytes, 0, packed_grid_bytes(sg.size(), false));
+
+	std::size_t pos = 0;
+	for (unsigned int x = 0; x < sg.size(); ++x) {
+		for (unsigned int y = 0; y < sg.size(); ++y, pos += bits) {
+			std::uint32_t v = sg.get_cell(x, y).get_value();
+			for (unsigned int b = 0; b < bits; ++b) {
+				if (v & (1u << b))
+					bytes[(pos + b) / 8] |= std::uint8_t(1u << ((pos + b) % 8));
+			}
+		}
+	}
+}
+
+void sudoku_solver::unpack(const std::uint8_t* bytes, Single_Value_Sudoku_Grid& sg) {
+	const unsigned int bits = packed_bits(sg.size());
+
+	std::size_t pos = 0;
+	for (unsigned int x = 0; x < sg.size(); ++x) {
+		for (unsigned int y = 0; y < sg.size(); ++y, pos += bits) {
+			std::uint32_t v = 0;
+			for (unsigned int b = 0; b < bits; ++b)
+				v |= std::uint32_t((bytes[(pos + b) / 8] >> ((pos + b) % 8)) & 1) << b;
+			if (v > sg.size())
+				throw std::runtime_error("value " + std::to_string(v) + " out of range in packed grid");
+			Single_Value_Cell& cell = sg.get_cell(x, y);
+			if (v == 0)
+				cell.clear();
+			else
+				cell.set_value(v);
+		}
+	}
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::final_values(const Multiple_Value_Sudoku_Grid& mg) {
+	Single_Value_Sudoku_Grid sg {mg.size()};
+	for (unsigned int x = 0; x < mg.size(); ++x) {
+		for (unsigned int y = 0; y < mg.size(); ++y) {
+			const Multiple_Value_Cell& cell = mg.get_cell(x, y);
+			if (cell.is_final() && cell.possibilities() == 1)
+				sg.get_cell(x, y).set_value(cell.get_values()[0]);
+		}
+	}
+	return sg;
+}
+
+Packed_File::Packed_File(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw system_error("cannot open", path);
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw system_error("cannot read", path);
+	}
+	_length = std::size_t(st.st_size);
+	if (_length < header_bytes) {
+		close(fd);
+		throw std::runtime_error(path + " is no packed file");
+	}
+
+	void* data = mmap(nullptr, _length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		throw system_error("cannot map", path);
+	_data = static_cast<const std::uint8_t*>(data);
+	// grids are mostly read in order
+	madvise(data, _length, MADV_SEQUENTIAL);
+
+	_size = _data[4] | (unsigned int) (_data[5]) << 8;
+	_with_status = _data[7] & packed_with_status;
+	for (unsigned int i = 0; i < 8; ++i)
+		_count |= std::uint64_t(_data[8 + i]) << (8 * i);
+	_grid_bytes = packed_grid_bytes(_size, _with_status);
+
+	unsigned int box_size = 1;
+	while (box_size * box_size < _size)
+		++box_size;
+	if (std::memcmp(_data, magic, sizeof(magic)) != 0 || _size == 0 || box_size * box_size != _size
+		|| _data[6] != packed_bits(_size) || (_length - header_bytes) / _grid_bytes < _count) {
+		munmap(data, _length);
+		throw std::runtime_error(path + " is no valid packed file");
+	}
+}
+
+Packed_File::~Packed_File() {
+	munmap(const_cast<std::uint8_t*>(_data), _length);
+}
+
+const std::uint8_t* Packed_File::_record(std::uint64_t index) const {
+	return _data + header_bytes + index * _grid_bytes;
+}
+
+void Packed_File::grid(std::uint64_t index, Single_Value_Sudoku_Grid& sg) const {
+	if (sg.size() != _size)
+		sg = Single_Value_Sudoku_Grid(_size);
+	unpack(_record(index) + (_with_status ? 1 : 0), sg);
+}
+
+void Packed_File::cells(std::uint64_t index, std::uint8_t* cells) const {
+	const std::uint8_t* bytes = _record(index) + (_with_status ? 1 : 0);
+	const std::size_t count = std::size_t(_size) * _size;
+	const unsigned int bits = packed_bits(_size);
+
+	// two cells per byte for 9x9 grids
+	if (bits == 4) {
+		for (std::size_t c = 0; c < count; ++c)
+			cells[c] = (bytes[c / 2] >> (4 * (c % 2))) & 0xf;
+		return;
+	}
+
+	std::size_t pos = 0;
+	for (std::size_t c = 0; c < count; ++c, pos += bits) {
+		unsigned int v = 0;
+		for (unsigned int b = 0; b < bits; ++b)
+			v |= unsigned((bytes[(pos + b) / 8] >> ((pos + b) % 8)) & 1) << b;
+		cells[c] = std::uint8_t(v);
+	}
+}
+
+Solve_Status Packed_File::status(std::uint64_t index) const {
+	return Solve_Status(*_record(index));
+}
+
+Packed_Writer::Packed_Writer(const std::string& path, unsigned int size, bool with_status)
+: _file(path, std::ios::binary | std::ios::trunc), _size(size), _with_status(with_status),
+  _buffer(packed_grid_bytes(size, with_status))
+{
+	if (!_file)
+		throw system_error("cannot create", path);
+
+	// the amount of grids is written by close
+	std::uint8_t header[header_bytes];
+	write_header(header, _size, _with_status, 0);
+	_file.write(reinterpret_cast<const char*>(header), header_bytes);
+}
+
+Packed_Writer::~Packed_Writer() {
+	if (_file.is_open())
+		close();
+}
+
+void Packed_Writer::write(const Single_Value_Sudoku_Grid& sg, Solve_Status status) {
+	std::uint8_t* bytes = _buffer.data();
+	if (_with_status)
+		*bytes++ = std::uint8_t(status);
+	pack(sg, bytes);
+	_file.write(reinterpret_cast<const char*>(_buffer.data()), std::streamsize(_buffer.size()));
+	++_count;
+}
+
+bool Packed_Writer::close() {
+	std::uint8_t header[header_bytes];
+	write_header(header, _size, _with_status, _count);
+	_file.seekp(0);
+	_file.write(reinterpret_cast<const char*>(header), header_bytes);
+	_file.close();
+	return !_file.fail();
+}
+
+Packed_Stats sudoku_solver::solve_packed(const std::string& input_path, const std::string& output_path,
+										 const Solve_Limits& limits, const Search_Options& options,
+										 unsigned int threads, std::size_t cache_size) {
+
+	Packed_File input {input_path};
+	const unsigned int size = input.size();
+	const std::size_t grid_bytes = packed_grid_bytes(size, true);
+	const std::size_t length = header_bytes + input.count() * grid_bytes;
+
+	// truncating the input would invalidate its mapping
+	struct stat input_stat, output_stat;
+	if (stat(input_path.c_str(), &input_stat) != 0)
+		throw system_error("cannot read", input_path);
+	if (stat(output_path.c_str(), &output_stat) == 0 && input_stat.st_dev == output_stat.st_dev
+		&& input_stat.st_ino == output_stat.st_ino)
+		throw std::runtime_error("cannot write " + output_path + ": same file as the input");
+
+	// all grids are checked before the output is touched (unpack throws on values out of range)
+	{
+		Single_Value_Sudoku_Grid sg {size};
+		for (std::uint64_t i = 0; i < input.count(); ++i)
+			input.grid(i, sg);
+	}
+
+	// the output file is created with its final length and mapped
+	int fd = open(output_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw system_error("cannot create", output_path);
+	if (ftruncate(fd, off_t(length)) != 0) {
+		close(fd);
+		throw system_error("cannot resize", output_path);
+	}
+	void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		throw system_error("cannot map", output_path);
+	std::uint8_t* output = static_cast<std::uint8_t*>(data);
+	write_header(output, size, true, input.count());
+
+	const Grid_Layout& layout = Grid_Layout::standard(size);
+	const std::uint64_t chunk = 256;
+	std::atomic<std::uint64_t> next {0};
+	std::atomic<std::uint64_t> solved {0};
+	std::atomic<unsigned long> cache_hits {0};
+
+	auto work = [&]() {
+		// one cache per thread (the cache is not synchronized)
+		std::unique_ptr<Solution_Cache> cache;
+		if (cache_size != 0)
+			cache.reset(new Solution_Cache(cache_size));
+		Single_Value_Sudoku_Grid sg {size};
+		std::uint64_t solved_here = 0;
+
+		for (std::uint64_t begin; (begin = next.fetch_add(chunk)) < input.count(); ) {
+			std::uint64_t end = std::min(begin + chunk, input.count());
+			for (std::uint64_t i = begin; i < end; ++i) {
+				input.grid(i, sg);
+				Solve_Result result = cache ? solve(sg, *cache, limits, options) : solve(sg, layout, limits, options);
+				if (result.status == Solve_Status::solved)
+					++solved_here;
+
+				std::uint8_t* record = output + header_bytes + i * grid_bytes;
+				record[0] = std::uint8_t(result.status);
+				pack(final_values(result.grid), record + 1);
+			}
+		}
+
+		solved += solved_here;
+		if (cache)
+			cache_hits += cache->hits();
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int t = 1; t < threads; ++t)
+		pool.emplace_back(work);
+	work();
+	for (std::thread& t : pool)
+		t.join();
+
+	munmap(data, length);
+
+	Packed_Stats stats;
+	stats.grids = input.count();
+	stats.solved = solved;
+	stats.cache_hits = cache_hits;
+	return stats;
+}
@@ -0,0 +1,120 @@
+//
+//  Packed.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Packed_h
+#define Packed_h
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "solve.h"
+
+namespace sudoku_solver {
+
+	// packed binary format of grids
+	//
+	//   header (16 bytes): 'SDKP', size (uint16), bits per cell (uint8), flags (uint8), amount of grids (uint64)
+	//   per grid: status (uint8, only if the flag with_status is set) followed by the cells
+	//
+	// Each cell takes ceil(log2(size + 1)) bits (4 bits for 9x9 grids), zero stands for an empty cell.
+	// The cells are stored in the order of the text format starting with the lowest bit and each grid
+	// is padded to whole bytes, so each grid can be accessed directly. All integers are little endian.
+
+	//! flag of the header: each grid is preceded by the status of its solving attempt (see Solve_Status)
+	const std::uint8_t packed_with_status = 1;
+
+	//! @return bits per cell of a grid of the given size
+	unsigned int packed_bits(unsigned int size);
+	//! @return bytes per grid (including the status if with_status is true)
+	std::size_t packed_grid_bytes(unsigned int size, bool with_status);
+
+	//! writes the cells of a grid to bytes of the packed format
+	void pack(const Single_Value_Sudoku_Grid& sg, std::uint8_t* bytes);
+	//! reads the cells of a grid from bytes of the packed format
+	//! @throws std::runtime_error if a value is larger than the size of the grid
+	void unpack(const std::uint8_t* bytes, Single_Value_Sudoku_Grid& sg);
+	//! @return grid with the values of the final cells (other cells are empty)
+	Single_Value_Sudoku_Grid final_values(const Multiple_Value_Sudoku_Grid& mg);
+
+	//! memory-mapped read-only file of packed grids
+	class Packed_File {
+
+	public:
+		//! @throws std::runtime_error if the file cannot be mapped or is no valid packed file
+		explicit Packed_File(const std::string& path);
+		~Packed_File();
+		Packed_File(const Packed_File&) = delete;
+		Packed_File& operator=(const Packed_File&) = delete;
+
+		unsigned int size() const {return _size;}
+		std::uint64_t count() const {return _count;}
+		bool with_status() const {return _with_status;}
+
+		//! reads the grid with the given index
+		//! @throws std::runtime_error if a value is larger than the size of the grid
+		void grid(std::uint64_t index, Single_Value_Sudoku_Grid& sg) const;
+		//! reads the values of the grid with the given index (one byte per cell index, sizes up to 255)
+		void cells(std::uint64_t index, std::uint8_t* cells) const;
+		//! @return status of the grid (only valid if with_status)
+		Solve_Status status(std::uint64_t index) const;
+
+	private:
+		const std::uint8_t* _data = nullptr;
+		std::size_t _length = 0;
+		unsigned int _size = 0;
+		std::uint64_t _count = 0;
+		bool _with_status = false;
+		std::size_t _grid_bytes = 0;
+
+		const std::uint8_t* _record(std::uint64_t index) const;
+	};
+
+	//! appends grids to a new file of packed grids
+	class Packed_Writer {
+
+	public:
+		//! @throws std::runtime_error if the file cannot be created
+		Packed_Writer(const std::string& path, unsigned int size, bool with_status);
+		//! completes the header
+		~Packed_Writer();
+		Packed_Writer(const Packed_Writer&) = delete;
+		Packed_Writer& operator=(const Packed_Writer&) = delete;
+
+		void write(const Single_Value_Sudoku_Grid& sg, Solve_Status status = Solve_Status::solved);
+		//! writes the amount of grids to the header
+		//! @return false if writing failed
+		bool close();
+
+	private:
+		std::ofstream _file;
+		unsigned int _size;
+		bool _with_status;
+		std::uint64_t _count = 0;
+		std::vector<std::uint8_t> _buffer;
+	};
+
+	//! statistics of solve_packed
+	struct Packed_Stats {
+		std::uint64_t grids = 0;
+		std::uint64_t solved = 0;
+		unsigned long cache_hits = 0;
+	};
+
+	//! solves all grids of a packed file and stores the results (with status) in another packed file
+	//! Both files are memory-mapped: each thread solves the grids of one chunk of indices after another
+	//! and writes the results directly into the output file.
+	//! @param cache_size capacity of the solution cache of each thread (zero disables the cache)
+	//! @throws std::runtime_error if a file cannot be mapped, both paths name the same file or a grid contains a
+	//! value out of range (the output file is left untouched then)
+	Packed_Stats solve_packed(const std::string& input_path, const std::string& output_path,
+							  const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options(),
+							  unsigned int threads = 1, std::size_t cache_size = 4096);
+
+}
+
+#endif /* Packed_h */
@@ -0,0 +1,166 @@
+//
+//  Pipeline.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Pipeline.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! grids passed between the stages
+	struct Block {
+		std::uint64_t sequence = 0;
+		std::vector<Single_Value_Sudoku_Grid> grids;
+		std::vector<Solve_Result> results;
+	};
+
+	//! waits for a condition without locks (yielding first, then sleeping for increasing periods up to 1ms)
+	//! @return time spent waiting
+	template <class Condition>
+	std::chrono::microseconds wait_until(const Condition& condition) {
+		if (condition())
+			return std::chrono::microseconds(0);
+
+		auto start = std::chrono::steady_clock::now();
+		std::chrono::microseconds sleep {50};
+		for (unsigned int attempt = 0; !condition(); ++attempt) {
+			if (attempt < 16) {
+				std::this_thread::yield();
+			} else {
+				std::this_thread::sleep_for(sleep);
+				sleep = std::min(2 * sleep, std::chrono::microseconds(1000));
+			}
+		}
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	}
+
+	void update_max(std::atomic<std::size_t>& max, std::size_t value) {
+		std::size_t current = max.load(std::memory_order_relaxed);
+		while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+	}
+
+}
+
+Pipeline_Stats sudoku_solver::run_pipeline(const std::function<bool(Single_Value_Sudoku_Grid&)>& read,
+										   const std::function<std::vector<Solve_Result>(const std::vector<Single_Value_Sudoku_Grid>&, unsigned int)>& solve,
+										   const std::function<void(const Solve_Result&)>& write,
+										   const Pipeline_Options& options) {
+
+	const unsigned int workers = options.workers == 0 ? 1 : options.workers;
+	const std::size_t block_size = options.block_size == 0 ? 1 : options.block_size;
+
+	Bounded_Queue<Block> input {options.queue_capacity};
+	Bounded_Queue<Block> output {options.queue_capacity};
+	// maximal amount of blocks read but not yet written (bounds the blocks kept by the writer for reordering)
+	const std::uint64_t window = input.capacity() + output.capacity() + workers;
+
+	std::atomic<std::uint64_t> written {0};
+	// amount of blocks once the input has ended
+	std::atomic<std::uint64_t> blocks {UINT64_MAX};
+	std::atomic<bool> reading {true};
+
+	std::atomic<std::size_t> max_input_depth {0};
+	std::atomic<std::size_t> max_output_depth {0};
+	std::atomic<std::int64_t> reader_stall {0};
+	std::atomic<std::int64_t> worker_input_stall {0};
+	std::atomic<std::int64_t> worker_output_stall {0};
+
+	std::thread reader {[&]() {
+		std::uint64_t sequence = 0;
+		std::chrono::microseconds stall {0};
+		Single_Value_Sudoku_Grid sg;
+
+		for (bool good = true; good; ) {
+			Block block;
+			block.sequence = sequence;
+			while (block.grids.size() < block_size && (good = read(sg)))
+				block.grids.push_back(sg);
+			if (block.grids.empty())
+				break;
+
+			stall += wait_until([&]() {return sequence - written.load(std::memory_order_acquire) < window;});
+			stall += wait_until([&]() {return input.try_push(block);});
+			update_max(max_input_depth, input.size());
+			++sequence;
+		}
+
+		reader_stall = stall.count();
+		blocks.store(sequence, std::memory_order_release);
+		reading.store(false, std::memory_order_release);
+	}};
+
+	std::vector<std::thread> pool;
+	for (unsigned int w = 0; w < workers; ++w) {
+		pool.emplace_back([&, w]() {
+			std::chrono::microseconds input_stall {0};
+			std::chrono::microseconds output_stall {0};
+			Block block;
+
+			while (true) {
+				bool ended = false;
+				input_stall += wait_until([&]() {
+					if (input.try_pop(block))
+						return true;
+					// (the input is checked once more after the reader has finished)
+					ended = !reading.load(std::memory_order_acquire) && !input.try_pop(block);
+					return ended;
+				});
+				if (ended)
+					break;
+
+				block.results = solve(block.grids, w);
+				block.grids.clear();
+
+				output_stall += wait_until([&]() {return output.try_push(block);});
+				update_max(max_output_depth, output.size());
+			}
+
+			worker_input_stall += input_stall.count();
+			worker_output_stall += output_stall.count();
+		});
+	}
+
+	// the writer keeps blocks which arrive out of order
+	Pipeline_Stats stats;
+	std::map<std::uint64_t, Block> pending;
+	Block block;
+
+	while (written.load(std::memory_order_relaxed) < blocks.load(std::memory_order_acquire)) {
+
+		std::uint64_t next = written.load(std::memory_order_relaxed);
+		auto it = pending.find(next);
+		if (it == pending.end()) {
+			stats.writer_stall += wait_until([&]() {
+				return output.try_pop(block) || next >= blocks.load(std::memory_order_acquire);
+			});
+			if (next < blocks.load(std::memory_order_acquire))
+				pending.emplace(block.sequence, std::move(block));
+			continue;
+		}
+
+		for (const Solve_Result& result : it->second.results)
+			write(result);
+		stats.grids += it->second.results.size();
+		pending.erase(it);
+		written.store(next + 1, std::memory_order_release);
+	}
+
+	reader.join();
+	for (std::thread& t : pool)
+		t.join();
+
+	stats.max_input_depth = max_input_depth;
+	stats.max_output_depth = max_output_depth;
+	stats.reader_stall = std::chrono::microseconds(reader_stall);
+	stats.worker_input_stall = std::chrono::microseconds(worker_input_stall);
+	stats.worker_output_stall = std::chrono::microseconds(worker_output_stall);
+	return stats;
+}
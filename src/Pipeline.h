@@ -0,0 +1,158 @@
+//
+//  Pipeline.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Pipeline_h
+#define Pipeline_h
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "solve.h"
+
+namespace sudoku_solver {
+
+	//! bounded lock-free queue for any amount of producers and consumers
+	//! Each slot carries a sequence number which tells producers resp. consumers whether the slot is free
+	//! resp. filled for their position (D. Vyukov's bounded MPMC queue).
+	template <class T>
+	class Bounded_Queue {
+
+	public:
+		//! @param capacity maximal amount of elements (rounded up to a power of two)
+		explicit Bounded_Queue(std::size_t capacity);
+		Bounded_Queue(const Bounded_Queue&) = delete;
+		Bounded_Queue& operator=(const Bounded_Queue&) = delete;
+
+		//! @return false if the queue is full (the element is not moved then)
+		bool try_push(T& element);
+		//! @return false if the queue is empty
+		bool try_pop(T& element);
+
+		//! @return amount of elements (approximate while other threads access the queue)
+		std::size_t size() const;
+		std::size_t capacity() const {return _slots.size();}
+
+	private:
+		struct Slot {
+			std::atomic<std::size_t> sequence;
+			T element;
+		};
+
+		std::vector<Slot> _slots;
+		std::size_t _mask;
+		// (separate cache lines for producers and consumers)
+		alignas(64) std::atomic<std::size_t> _push_pos {0};
+		alignas(64) std::atomic<std::size_t> _pop_pos {0};
+	};
+
+	//! statistics of a pipeline run
+	struct Pipeline_Stats {
+		unsigned long grids = 0;
+		//! maximal amount of blocks waiting for a worker resp. the writer
+		std::size_t max_input_depth = 0;
+		std::size_t max_output_depth = 0;
+		//! time the reader waited for free space (queue full or too many blocks not yet written)
+		std::chrono::microseconds reader_stall {0};
+		//! time all workers together waited for input resp. for free space in the output queue
+		std::chrono::microseconds worker_input_stall {0};
+		std::chrono::microseconds worker_output_stall {0};
+		//! time the writer waited for the next block in order
+		std::chrono::microseconds writer_stall {0};
+	};
+
+	struct Pipeline_Options {
+		//! amount of solver threads
+		unsigned int workers = 1;
+		//! capacity of the queues between the stages (in blocks)
+		std::size_t queue_capacity = 64;
+		//! amount of grids per block
+		std::size_t block_size = 1;
+	};
+
+	//! reads, solves and writes grids in three overlapping stages: a reader thread, a pool of workers and
+	//! a writer (the calling thread) which writes the results in the order of the grids. The stages exchange
+	//! blocks of grids via bounded queues and the reader stays at most a fixed amount of blocks ahead of the
+	//! writer, so the memory used does not depend on the amount of grids.
+	//! @param read reads the next grid, returns false at the end of the input
+	//! @param solve solves a block of grids (the second parameter is the index of the worker)
+	//! @param write writes a result
+	Pipeline_Stats run_pipeline(const std::function<bool(Single_Value_Sudoku_Grid&)>& read,
+								const std::function<std::vector<Solve_Result>(const std::vector<Single_Value_Sudoku_Grid>&, unsigned int)>& solve,
+								const std::function<void(const Solve_Result&)>& write,
+								const Pipeline_Options& options = Pipeline_Options());
+
+	template <class T>
+	Bounded_Queue<T>::Bounded_Queue(std::size_t capacity) {
+		std::size_t size = 2;
+		while (size < capacity)
+			size *= 2;
+		_slots = std::vector<Slot>(size);
+		_mask = size - 1;
+		for (std::size_t i = 0; i < size; ++i)
+			_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	template <class T>
+	bool Bounded_Queue<T>::try_push(T& element) {
+		std::size_t pos = _push_pos.load(std::memory_order_relaxed);
+		while (true) {
+			Slot& slot = _slots[pos & _mask];
+			std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			std::intptr_t diff = std::intptr_t(sequence) - std::intptr_t(pos);
+			if (diff == 0) {
+				// the slot is free for this position: claim it
+				if (_push_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					slot.element = std::move(element);
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) {
+				// the slot still holds the element of the previous round
+				return false;
+			} else {
+				pos = _push_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template <class T>
+	bool Bounded_Queue<T>::try_pop(T& element) {
+		std::size_t pos = _pop_pos.load(std::memory_order_relaxed);
+		while (true) {
+			Slot& slot = _slots[pos & _mask];
+			std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			std::intptr_t diff = std::intptr_t(sequence) - std::intptr_t(pos + 1);
+			if (diff == 0) {
+				// the slot is filled for this position: claim it
+				if (_pop_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					element = std::move(slot.element);
+					slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) {
+				// not yet filled
+				return false;
+			} else {
+				pos = _pop_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template <class T>
+	std::size_t Bounded_Queue<T>::size() const {
+		std::size_t push_pos = _push_pos.load(std::memory_order_relaxed);
+		std::size_t pop_pos = _pop_pos.load(std::memory_order_relaxed);
+		return push_pos > pop_pos ? push_pos - pop_pos : 0;
+	}
+
+}
+
+#endif /* Pipeline_h */
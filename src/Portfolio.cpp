@@ -0,0 +1,136 @@
+//
+//  Portfolio.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Portfolio.h"
+
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include "Search.h"
+#include "Singles.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! amount of assumptions between checks of the caller's cancellation token
+	const unsigned long slice = 256;
+
+	//! restart interval of random searches if the base options have none
+	const unsigned long default_restart_interval = 100;
+
+	const std::size_t no_winner = SIZE_MAX;
+
+	//! joins all started threads when it goes out of scope (the searches are cancelled first unless
+	//! the portfolio ended regularly, e.g. if an exception leaves it)
+	struct Join_Guard {
+		std::vector<std::thread>& threads;
+		Cancellation_Token& cancellation;
+		bool ended = false;
+
+		~Join_Guard() {
+			if (!ended)
+				cancellation.cancel();
+			for (std::thread& t : threads) {
+				if (t.joinable())
+					t.join();
+			}
+		}
+	};
+
+}
+
+std::vector<Search_Options> sudoku_solver::portfolio(unsigned int searches, const Search_Options& base) {
+
+	std::vector<Search_Options> configurations;
+
+	// the first search keeps the given order, the others try the remaining orders
+	configurations.push_back(base);
+	for (Branching b : {Branching::scan, Branching::constraint, Branching::degree}) {
+		if (configurations.size() < searches && b != base.branching) {
+			configurations.push_back(base);
+			configurations.back().branching = b;
+		}
+	}
+
+	// all further searches differ by their random order
+	while (configurations.size() < searches) {
+		Search_Options options = base;
+		options.branching = Branching::random;
+		options.seed = base.seed + configurations.size();
+		if (options.restart_interval == 0)
+			options.restart_interval = default_restart_interval;
+		configurations.push_back(options);
+	}
+	return configurations;
+}
+
+Solve_Result sudoku_solver::solve_portfolio(const Single_Value_Sudoku_Grid& sg_start, const Grid_Layout& layout,
+											const std::vector<Search_Options>& configurations,
+											const Solve_Limits& limits, std::size_t* winner) {
+
+	if (configurations.empty())
+		return solve(sg_start, layout, limits);
+
+	// the searches are cancelled by the winner or by the caller
+	Cancellation_Token cancellation;
+	Solve_Limits search_limits = limits;
+	search_limits.cancellation = &cancellation;
+
+	// grids solved by singles need no search
+	Multiple_Value_Sudoku_Grid mg_start {sg_start.size()};
+	Solve_Stats singles_stats;
+	if (solve_singles(sg_start, layout, mg_start, singles_stats)) {
+		if (winner)
+			*winner = 0;
+		return {std::move(mg_start), Solve_Status::solved, "solved", singles_stats};
+	}
+
+	std::atomic<std::size_t> first {no_winner};
+	std::vector<Solve_Result> results (configurations.size());
+
+	auto search = [&](std::size_t i) {
+
+		Search_Engine engine {mg_start, layout, search_limits, configurations[i]};
+		while (!engine.run(slice)) {
+			if (limits.cancellation && limits.cancellation->cancelled())
+				cancellation.cancel();
+		}
+
+		results[i] = engine.result();
+
+		// only definite answers win
+		if (results[i].status == Solve_Status::solved || results[i].status == Solve_Status::contradiction) {
+			std::size_t expected = no_winner;
+			if (first.compare_exchange_strong(expected, i))
+				cancellation.cancel();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	Join_Guard guard {threads, cancellation};
+	// if a thread cannot be started the portfolio continues with fewer searches
+	try {
+		threads.reserve(configurations.size() - 1);
+		for (std::size_t i = 1; i < configurations.size(); ++i)
+			threads.emplace_back(search, i);
+	} catch (const std::system_error&) { }
+	search(0);
+	guard.ended = true;
+	for (std::thread& t : threads)
+		t.join();
+
+	std::size_t w = first.load();
+	if (w == no_winner)
+		w = 0;
+	if (winner)
+		*winner = w;
+	results[w].stats.propagation_rounds += singles_stats.propagation_rounds;
+	results[w].stats.time += singles_stats.time;
+	return std::move(results[w]);
+}
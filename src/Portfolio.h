@@ -0,0 +1,34 @@
+//
+//  Portfolio.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Portfolio_h
+#define Portfolio_h
+
+#include <cstddef>
+#include <vector>
+#include "solve.h"
+
+namespace sudoku_solver {
+
+	//! @return differently configured searches diversifying the given options
+	//! (scan, constraint, degree and random order; random orders use restarts and consecutive seeds)
+	//! @param searches amount of configurations (at least one)
+	std::vector<Search_Options> portfolio(unsigned int searches, const Search_Options& base);
+
+	//! runs one search per configuration for the same grid in parallel (one thread each, configurations whose
+	//! thread cannot be started are skipped)
+	//! The first search which solves the grid or finds a contradiction wins and cancels all others.
+	//! @param winner receives the index of the winning configuration (the first one if none has won)
+	//! @return result of the winning search (of the first one if all were interrupted)
+	Solve_Result solve_portfolio(const Single_Value_Sudoku_Grid& sg_start, const Grid_Layout& layout,
+								 const std::vector<Search_Options>& configurations,
+								 const Solve_Limits& limits = Solve_Limits(), std::size_t* winner = nullptr);
+
+}
+
+#endif /* Portfolio_h */
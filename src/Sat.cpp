@@ -0,0 +1,642 @@
+//
+//  Sat.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Sat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "util.h"
+
+using namespace sudoku_solver;
+
+// the constants are bound to references (e.g. by std::vector), so they need a definition
+const std::uint8_t Sat_Solver::false_value;
+const std::uint8_t Sat_Solver::true_value;
+const std::uint8_t Sat_Solver::undefined;
+const std::uint32_t Sat_Solver::no_reason;
+const std::uint32_t Sat_Solver::binary;
+const unsigned long Sat_Solver::restart_unit;
+
+Sat_Solver::Sat_Solver(std::size_t variables)
+: _max_learned(0), _watches(2 * variables), _assigns(variables, undefined), _phases(variables, true_value),
+  _levels(variables, 0), _reasons(variables, no_reason), _activities(variables, 0.0),
+  _heap_positions(variables, -1), _seen(variables, 0)
+{
+	for (variable_t v = 0; v < variables; ++v)
+		_heap_insert(v);
+}
+
+bool Sat_Solver::add_clause(std::vector<literal_t> literals) {
+
+	if (_unsatisfiable)
+		return false;
+	_backtrack(0);
+
+	// drops false and duplicate literals, satisfied clauses and tautologies (a literal and its negation are adjacent)
+	std::sort(literals.begin(), literals.end());
+	std::size_t size = 0;
+	for (literal_t l : literals) {
+		if (_value(l) == true_value || (size != 0 && literals[size - 1] == (l ^ 1)))
+			return true;
+		if (_value(l) == false_value || (size != 0 && literals[size - 1] == l))
+			continue;
+		literals[size++] = l;
+	}
+	literals.resize(size);
+
+	if (size == 0) {
+		_unsatisfiable = true;
+	} else if (size == 1) {
+		_assign(literals[0], no_reason);
+		_unsatisfiable = _propagate() != no_reason;
+	} else {
+		_attach(literals, false);
+	}
+	return !_unsatisfiable;
+}
+
+Sat_Solver::Result Sat_Solver::solve(const std::function<bool()>& interrupted) {
+
+	if (_unsatisfiable)
+		return Result::unsatisfiable;
+	_backtrack(0);
+	if (_max_learned == 0)
+		_max_learned = std::max<std::size_t>(_original_clauses / 3, 10000);
+
+	unsigned long conflicts = 0;
+	for (;;) {
+		std::uint32_t conflict = _propagate();
+
+		if (conflict != no_reason) {
+			++_stats.conflicts;
+			++conflicts;
+			if (_level() == 0) {
+				_unsatisfiable = true;
+				return Result::unsatisfiable;
+			}
+
+			// learns the clause and asserts its first literal right after jumping back
+			_backtrack(_analyze(conflict));
+			const literal_t asserted = _learned_literals[0];
+			if (_learned_literals.size() == 1) {
+				_assign(asserted, no_reason);
+			} else {
+				std::uint32_t clause = _attach(_learned_literals, true);
+				if (clause != no_reason)
+					_bump_clause(clause);
+				_assign(asserted, clause != no_reason ? clause : binary | _learned_literals[1]);
+			}
+			++_stats.learned_clauses;
+			_variable_increment /= 0.95;
+			_clause_increment /= 0.999f;
+
+			if (interrupted())
+				return Result::interrupted;
+			continue;
+		}
+
+		if (conflicts >= restart_unit * luby(_stats.restarts + 1)) {
+			++_stats.restarts;
+			conflicts = 0;
+			_backtrack(0);
+			continue;
+		}
+		if (_learned.size() >= _max_learned)
+			_reduce();
+
+		if (interrupted())
+			return Result::interrupted;
+
+		literal_t decision = _decide();
+		if (decision == 2 * _assigns.size())
+			return Result::satisfiable;
+
+		++_stats.decisions;
+		_level_starts.push_back(_trail.size());
+		_stats.max_level = std::max(_stats.max_level, _level());
+		_assign(decision, no_reason);
+	}
+}
+
+std::size_t Sat_Solver::memory() const {
+	std::size_t watches = 0;
+	for (const std::vector<Watch>& w : _watches)
+		watches += w.capacity();
+	return _arena.capacity() * sizeof(std::uint32_t)
+		 + watches * sizeof(Watch)
+		 + _assigns.size() * (3 * sizeof(std::uint8_t) + 3 * sizeof(std::uint32_t) + sizeof(double) + sizeof(literal_t))
+		 + _learned.capacity() * sizeof(std::uint32_t);
+}
+
+float Sat_Solver::_activity(std::uint32_t clause) const {
+	float activity;
+	std::memcpy(&activity, &_arena[clause + 2], sizeof(activity));
+	return activity;
+}
+
+void Sat_Solver::_set_activity(std::uint32_t clause, float activity) {
+	std::memcpy(&_arena[clause + 2], &activity, sizeof(activity));
+}
+
+std::uint32_t Sat_Solver::_attach(const std::vector<literal_t>& literals, bool learned) {
+
+	if (literals.size() == 2) {
+		_watches[literals[0]].push_back({binary, literals[1]});
+		_watches[literals[1]].push_back({binary, literals[0]});
+		++_binary_clauses;
+		return no_reason;
+	}
+
+	std::uint32_t clause = std::uint32_t(_arena.size());
+	_arena.push_back(std::uint32_t(literals.size()));
+	_arena.push_back(learned);
+	_arena.push_back(0);
+	_arena.insert(_arena.end(), literals.begin(), literals.end());
+	_set_activity(clause, 0.0f);
+
+	_watches[literals[0]].push_back({clause, literals[1]});
+	_watches[literals[1]].push_back({clause, literals[0]});
+	if (learned)
+		_learned.push_back(clause);
+	else
+		++_original_clauses;
+	return clause;
+}
+
+void Sat_Solver::_assign(literal_t l, std::uint32_t reason) {
+	const variable_t v = l >> 1;
+	_assigns[v] = std::uint8_t((l & 1) ^ 1);
+	_levels[v] = _level();
+	_reasons[v] = reason;
+	_trail.push_back(l);
+}
+
+std::uint32_t Sat_Solver::_propagate() {
+
+	std::uint32_t conflict = no_reason;
+
+	while (_head < _trail.size() && conflict == no_reason) {
+		// the clauses watching the negation of the assigned literal lose a candidate
+		const literal_t f = _trail[_head++] ^ 1;
+		std::vector<Watch>& watches = _watches[f];
+		++_stats.propagations;
+
+		Watch* i = watches.data();
+		Watch* j = i;
+		Watch* const end = i + watches.size();
+		while (i != end) {
+			const Watch w = *i++;
+			const std::uint8_t blocker = _value(w.blocker);
+			if (blocker == true_value) {
+				*j++ = w;
+				continue;
+			}
+
+			if (w.clause == binary) {
+				*j++ = w;
+				if (blocker == false_value) {
+					conflict = binary | w.blocker;
+					_conflict_literal = f;
+					while (i != end)
+						*j++ = *i++;
+				} else {
+					_assign(w.blocker, binary | f);
+				}
+				continue;
+			}
+
+			// the false literal is moved to position 1
+			literal_t* c = _literals(w.clause);
+			if (c[0] == f)
+				std::swap(c[0], c[1]);
+			const literal_t first = c[0];
+			const Watch kept {w.clause, first};
+			if (first != w.blocker && _value(first) == true_value) {
+				*j++ = kept;
+				continue;
+			}
+
+			// watches another literal which is not false
+			const std::uint32_t size = _size(w.clause);
+			std::uint32_t k = 2;
+			while (k < size && _value(c[k]) == false_value)
+				++k;
+			if (k < size) {
+				c[1] = c[k];
+				c[k] = f;
+				_watches[c[1]].push_back(kept);
+				continue;
+			}
+
+			// all literals but the first are false
+			*j++ = kept;
+			if (_value(first) == false_value) {
+				conflict = w.clause;
+				while (i != end)
+					*j++ = *i++;
+			} else {
+				_assign(first, w.clause);
+			}
+		}
+		watches.resize(std::size_t(j - watches.data()));
+	}
+	return conflict;
+}
+
+std::uint32_t Sat_Solver::_analyze(std::uint32_t conflict) {
+
+	// the clause is resolved with the reasons of the literals of the current level in reverse trail order
+	// until a single one is left (first unique implication point)
+	_learned_literals.assign(1, 0);
+	const literal_t none = UINT32_MAX;
+	literal_t p = none;
+	std::uint32_t reason = conflict;
+	std::size_t index = _trail.size();
+	unsigned int open = 0;
+
+	for (;;) {
+		literal_t pair[2];
+		const literal_t* literals;
+		std::uint32_t size;
+		if (reason & binary) {
+			pair[0] = p == none ? _conflict_literal : p;
+			pair[1] = reason & ~binary;
+			literals = pair;
+			size = 2;
+		} else {
+			if (_arena[reason + 1])
+				_bump_clause(reason);
+			literals = _literals(reason);
+			size = _size(reason);
+		}
+
+		// the implied literal itself is at position 0 of its reason
+		for (std::uint32_t k = p == none ? 0 : 1; k < size; ++k) {
+			const literal_t q = literals[k];
+			const variable_t v = q >> 1;
+			if (_seen[v] || _levels[v] == 0)
+				continue;
+			_seen[v] = 1;
+			_bump(v);
+			if (_levels[v] >= _level())
+				++open;
+			else
+				_learned_literals.push_back(q);
+		}
+
+		while (!_seen[_trail[--index] >> 1]) { }
+		p = _trail[index];
+		_seen[p >> 1] = 0;
+		reason = _reasons[p >> 1];
+		if (--open == 0)
+			break;
+	}
+	_learned_literals[0] = p ^ 1;
+
+	// drops literals implied by the other ones (the flags of all literals are cleared afterwards)
+	_analyzed.assign(_learned_literals.begin() + 1, _learned_literals.end());
+	std::size_t size = 1;
+	for (literal_t l : _analyzed) {
+		if (!_redundant(l))
+			_learned_literals[size++] = l;
+	}
+	for (literal_t l : _analyzed)
+		_seen[l >> 1] = 0;
+	_learned_literals.resize(size);
+
+	if (size == 1)
+		return 0;
+
+	// the literal of the highest remaining level is watched next to the asserted one
+	std::size_t highest = 1;
+	for (std::size_t k = 2; k < size; ++k) {
+		if (_levels[_learned_literals[k] >> 1] > _levels[_learned_literals[highest] >> 1])
+			highest = k;
+	}
+	std::swap(_learned_literals[1], _learned_literals[highest]);
+	return _levels[_learned_literals[1] >> 1];
+}
+
+bool Sat_Solver::_redundant(literal_t l) {
+
+	const std::uint32_t reason = _reasons[l >> 1];
+	if (reason == no_reason)
+		return false;
+
+	auto implied = [this](literal_t q) {return _seen[q >> 1] || _levels[q >> 1] == 0;};
+	if (reason & binary)
+		return implied(reason & ~binary);
+
+	const literal_t* literals = _literals(reason);
+	for (std::uint32_t k = 1; k < _size(reason); ++k) {
+		if (!implied(literals[k]))
+			return false;
+	}
+	return true;
+}
+
+void Sat_Solver::_backtrack(std::uint32_t level) {
+
+	if (_level() <= level)
+		return;
+
+	for (std::size_t i = _trail.size(); i-- > _level_starts[level]; ) {
+		const variable_t v = _trail[i] >> 1;
+		_phases[v] = _assigns[v];
+		_assigns[v] = undefined;
+		if (_heap_positions[v] < 0)
+			_heap_insert(v);
+	}
+	_trail.resize(_level_starts[level]);
+	_level_starts.resize(level);
+	_head = _trail.size();
+}
+
+Sat_Solver::literal_t Sat_Solver::_decide() {
+	while (!_heap.empty()) {
+		variable_t v = _heap_pop();
+		if (_assigns[v] == undefined)
+			return literal(v, _phases[v] == false_value);
+	}
+	return literal_t(2 * _assigns.size());
+}
+
+void Sat_Solver::_reduce() {
+
+	// clauses which are the reason of an assigned literal are kept
+	auto locked = [this](std::uint32_t clause) {
+		const literal_t first = _literals(clause)[0];
+		return _value(first) == true_value && _reasons[first >> 1] == clause;
+	};
+
+	std::sort(_learned.begin(), _learned.end(), [this](std::uint32_t a, std::uint32_t b) {
+		return _activity(a) < _activity(b);
+	});
+	for (std::size_t i = 0; i < _learned.size() / 2; ++i) {
+		if (!locked(_learned[i]))
+			_arena[_learned[i] + 1] |= 2;
+	}
+
+	// the remaining clauses are moved to the front, the activity field of a moved clause receives its new position
+	std::vector<std::uint32_t> arena;
+	arena.reserve(_arena.size());
+	for (std::uint32_t clause = 0; clause < _arena.size(); clause += 3 + _size(clause)) {
+		if (_arena[clause + 1] & 2)
+			continue;
+		const std::uint32_t moved = std::uint32_t(arena.size());
+		arena.insert(arena.end(), _arena.begin() + clause, _arena.begin() + clause + 3 + _size(clause));
+		_arena[clause + 2] = moved;
+	}
+	for (variable_t v = 0; v < _assigns.size(); ++v) {
+		if (_assigns[v] != undefined && _reasons[v] != no_reason && !(_reasons[v] & binary))
+			_reasons[v] = _arena[_reasons[v] + 2];
+	}
+	std::size_t kept = 0;
+	for (std::uint32_t clause : _learned) {
+		if (!(_arena[clause + 1] & 2))
+			_learned[kept++] = _arena[clause + 2];
+	}
+	_learned.resize(kept);
+	_arena.swap(arena);
+
+	// watches of binary clauses stay, the others are rebuilt
+	for (std::vector<Watch>& watches : _watches) {
+		watches.erase(std::remove_if(watches.begin(), watches.end(), [](const Watch& w) {return w.clause != binary;}),
+					  watches.end());
+	}
+	for (std::uint32_t clause = 0; clause < _arena.size(); clause += 3 + _size(clause)) {
+		const literal_t* c = _literals(clause);
+		_watches[c[0]].push_back({clause, c[1]});
+		_watches[c[1]].push_back({clause, c[0]});
+	}
+
+	_max_learned += _max_learned / 10;
+}
+
+void Sat_Solver::_bump(variable_t v) {
+	if ((_activities[v] += _variable_increment) > 1e100) {
+		for (double& a : _activities)
+			a *= 1e-100;
+		_variable_increment *= 1e-100;
+	}
+	if (_heap_positions[v] >= 0)
+		_heap_up(std::size_t(_heap_positions[v]));
+}
+
+void Sat_Solver::_bump_clause(std::uint32_t clause) {
+	_set_activity(clause, _activity(clause) + _clause_increment);
+	if (_activity(clause) > 1e20f) {
+		for (std::uint32_t c : _learned)
+			_set_activity(c, _activity(c) * 1e-20f);
+		_clause_increment *= 1e-20f;
+	}
+}
+
+void Sat_Solver::_heap_insert(variable_t v) {
+	_heap_positions[v] = std::int32_t(_heap.size());
+	_heap.push_back(v);
+	_heap_up(_heap.size() - 1);
+}
+
+void Sat_Solver::_heap_up(std::size_t i) {
+	const variable_t v = _heap[i];
+	while (i != 0) {
+		std::size_t parent = (i - 1) / 2;
+		if (_activities[_heap[parent]] >= _activities[v])
+			break;
+		_heap[i] = _heap[parent];
+		_heap_positions[_heap[i]] = std::int32_t(i);
+		i = parent;
+	}
+	_heap[i] = v;
+	_heap_positions[v] = std::int32_t(i);
+}
+
+void Sat_Solver::_heap_down(std::size_t i) {
+	const variable_t v = _heap[i];
+	for (;;) {
+		std::size_t child = 2 * i + 1;
+		if (child >= _heap.size())
+			break;
+		if (child + 1 < _heap.size() && _activities[_heap[child + 1]] > _activities[_heap[child]])
+			++child;
+		if (_activities[_heap[child]] <= _activities[v])
+			break;
+		_heap[i] = _heap[child];
+		_heap_positions[_heap[i]] = std::int32_t(i);
+		i = child;
+	}
+	_heap[i] = v;
+	_heap_positions[v] = std::int32_t(i);
+}
+
+Sat_Solver::variable_t Sat_Solver::_heap_pop() {
+	const variable_t top = _heap[0];
+	_heap_positions[top] = -1;
+	_heap[0] = _heap.back();
+	_heap.pop_back();
+	if (!_heap.empty()) {
+		_heap_positions[_heap[0]] = 0;
+		_heap_down(0);
+	}
+	return top;
+}
+
+namespace {
+
+	//! @return the grid with the given possible values per cell and value (given cells are final)
+	Multiple_Value_Sudoku_Grid possibility_grid(const std::vector<std::uint8_t>& possible, const std::vector<value_t>& givens,
+												unsigned int n) {
+		Multiple_Value_Sudoku_Grid mg {n};
+		for (cell_index_t c = 0; c < n * n; ++c) {
+			Multiple_Value_Cell& cell = mg.get_cell(c / n, c % n);
+			for (value_t v = 1; v <= n; ++v) {
+				if (possible[c * n + v - 1])
+					cell.add_value(v);
+			}
+			if (givens[c] != 0)
+				cell.make_final();
+		}
+		return mg;
+	}
+
+}
+
+Solve_Result sudoku_solver::solve_sat(const Single_Value_Sudoku_Grid& sg_start, const Grid_Layout& layout,
+									  const Solve_Limits& limits, const Search_Options& options) {
+
+	const auto start = std::chrono::steady_clock::now();
+	const unsigned int n = layout.size();
+	const cell_index_t cells = layout.cells();
+	using literal_t = Sat_Solver::literal_t;
+	auto variable = [n](cell_index_t c, value_t v) {return Sat_Solver::variable_t(c * n + v - 1);};
+
+	// the givens are cancelled in their peers (a peer with the same given has no possible value left)
+	std::vector<std::uint8_t> possible (std::size_t(cells) * n, 1);
+	std::vector<value_t> givens (cells);
+	for (cell_index_t c = 0; c < cells; ++c) {
+		givens[c] = sg_start.get_cell(c / n, c % n).get_value();
+		for (value_t v = 1; givens[c] != 0 && v <= n; ++v)
+			possible[variable(c, v)] = v == givens[c];
+	}
+	for (cell_index_t c = 0; c < cells; ++c) {
+		for (std::uint32_t i = 0; givens[c] != 0 && i < layout.peer_count(c); ++i)
+			possible[variable(layout.peers(c)[i], givens[c])] = 0;
+	}
+
+	Sat_Solver solver {std::size_t(cells) * n};
+	std::vector<literal_t> clause;
+	bool satisfiable = true;
+
+	for (cell_index_t c = 0; c < cells && satisfiable; ++c) {
+		// impossible values are false, one of the others is true
+		clause.clear();
+		for (value_t v = 1; v <= n; ++v) {
+			if (possible[variable(c, v)])
+				clause.push_back(Sat_Solver::literal(variable(c, v)));
+			else
+				satisfiable = solver.add_clause({Sat_Solver::literal(variable(c, v), true)});
+		}
+		satisfiable = satisfiable && solver.add_clause(clause);
+
+		// at most one value per cell
+		for (std::size_t i = 0; i < clause.size() && satisfiable; ++i) {
+			for (std::size_t j = i + 1; j < clause.size() && satisfiable; ++j)
+				satisfiable = solver.add_clause({clause[i] ^ 1, clause[j] ^ 1});
+		}
+
+		// at most one cell per value and unit (each pair of peers once)
+		for (std::uint32_t i = 0; i < layout.peer_count(c) && satisfiable; ++i) {
+			const cell_index_t p = layout.peers(c)[i];
+			for (value_t v = 1; p > c && v <= n && satisfiable; ++v) {
+				if (possible[variable(c, v)] && possible[variable(p, v)])
+					satisfiable = solver.add_clause({Sat_Solver::literal(variable(c, v), true),
+													 Sat_Solver::literal(variable(p, v), true)});
+			}
+		}
+	}
+
+	// at least one cell per value and unit
+	for (std::size_t u = 0; u < layout.units() && satisfiable; ++u) {
+		for (value_t v = 1; v <= n && satisfiable; ++v) {
+			clause.clear();
+			for (cell_index_t i = 0; i < n; ++i) {
+				const cell_index_t c = layout.unit_cells(u)[i];
+				if (possible[variable(c, v)])
+					clause.push_back(Sat_Solver::literal(variable(c, v)));
+			}
+			satisfiable = solver.add_clause(clause);
+		}
+	}
+
+	Solve_Result result;
+	result.status = Solve_Status::contradiction;
+	const auto deadline = start + limits.time;
+	auto interrupted = [&]() {
+		if (limits.cancellation && limits.cancellation->cancelled())
+			result.status = Solve_Status::cancelled;
+		else if (limits.time.count() != 0 && std::chrono::steady_clock::now() >= deadline)
+			result.status = Solve_Status::timeout;
+		else if (limits.assumptions != 0 && solver.stats().decisions >= limits.assumptions)
+			result.status = Solve_Status::assumption_limit;
+		else if (limits.memory != 0 && solver.memory() > limits.memory)
+			result.status = Solve_Status::memory_limit;
+		else
+			return false;
+		return true;
+	};
+
+	// each model found is excluded by a clause requiring another value in one of the empty cells
+	Sat_Solver::Result outcome = satisfiable ? Sat_Solver::Result::satisfiable : Sat_Solver::Result::unsatisfiable;
+	while (outcome == Sat_Solver::Result::satisfiable) {
+		outcome = solver.solve(interrupted);
+		if (outcome != Sat_Solver::Result::satisfiable)
+			break;
+
+		if (++result.stats.solutions == 1) {
+			std::vector<std::uint8_t> model (possible.size(), 0);
+			for (Sat_Solver::variable_t v = 0; v < model.size(); ++v)
+				model[v] = solver.model(v);
+			result.grid = possibility_grid(model, std::vector<value_t>(cells, 1), n);
+		}
+		if (result.stats.solutions == options.solution_limit)
+			break;
+
+		clause.clear();
+		for (cell_index_t c = 0; c < cells; ++c) {
+			for (value_t v = 1; givens[c] == 0 && v <= n; ++v) {
+				if (solver.model(variable(c, v)))
+					clause.push_back(Sat_Solver::literal(variable(c, v), true));
+			}
+		}
+		if (!solver.add_clause(clause))
+			outcome = Sat_Solver::Result::unsatisfiable;
+	}
+
+	if (outcome == Sat_Solver::Result::interrupted) {
+		result.reason = to_string(result.status);
+	} else if (result.stats.solutions != 0) {
+		result.status = Solve_Status::solved;
+		result.reason = "solved";
+	} else {
+		result.reason = "unsatisfiable";
+	}
+	if (result.stats.solutions == 0)
+		result.grid = possibility_grid(possible, givens, n);
+
+	const Sat_Solver::Stats& stats = solver.stats();
+	result.stats.assumptions = stats.decisions;
+	result.stats.propagation_rounds = stats.propagations;
+	result.stats.max_depth = stats.max_level;
+	result.stats.learned_nogoods = stats.learned_clauses;
+	result.stats.restarts = stats.restarts;
+	result.stats.peak_memory = solver.memory();
+	result.stats.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	return result;
+}
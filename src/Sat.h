@@ -0,0 +1,161 @@
+//
+//  Sat.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Sat_h
+#define Sat_h
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "solve.h"
+
+namespace sudoku_solver {
+
+	//! self-contained CDCL solver for formulas in conjunctive normal form
+	//! Clauses watch two of their literals (binary clauses are kept in the watch lists only). Conflicts are
+	//! analyzed to their first unique implication point and the learned clause is minimized. Decisions follow
+	//! the variable activity (VSIDS) and the saved phase. The search restarts after the Luby sequence times
+	//! restart_unit conflicts; half of the learned clauses (the least active ones) are dropped whenever
+	//! their amount exceeds a limit which grows by 10% each time.
+	class Sat_Solver {
+
+	public:
+		using variable_t = std::uint32_t;
+		//! 2 * variable resp. 2 * variable + 1 for its negation
+		using literal_t = std::uint32_t;
+
+		enum class Result {satisfiable, unsatisfiable, interrupted};
+
+		struct Stats {
+			unsigned long decisions = 0;
+			unsigned long propagations = 0;
+			unsigned long conflicts = 0;
+			unsigned long learned_clauses = 0;
+			unsigned long restarts = 0;
+			unsigned int max_level = 0;
+		};
+
+		static literal_t literal(variable_t v, bool negated = false) {return 2 * v + negated;}
+
+		explicit Sat_Solver(std::size_t variables);
+
+		//! adds a clause (also after solve, e.g. to exclude a model)
+		//! @return false if the formula is unsatisfiable
+		bool add_clause(std::vector<literal_t> literals);
+
+		//! searches a model of all clauses added so far
+		//! @param interrupted checked before each decision and after each conflict, the search ends once it returns true
+		Result solve(const std::function<bool()>& interrupted);
+
+		//! @return value of the variable in the model found by the last call of solve
+		bool model(variable_t v) const {return _assigns[v] == true_value;}
+
+		const Stats& stats() const {return _stats;}
+		//! @return estimated amount of bytes used by clauses, watches and variables
+		std::size_t memory() const;
+
+	private:
+		static const std::uint8_t false_value = 0;
+		static const std::uint8_t true_value = 1;
+		static const std::uint8_t undefined = 2;
+		static const std::uint32_t no_reason = UINT32_MAX;
+		//! reasons resp. conflicts with this bit are binary clauses (the other bits are their other literal)
+		static const std::uint32_t binary = 0x80000000u;
+		static const unsigned long restart_unit = 100;
+
+		//! clause watching a literal and one of its other literals (skips the clause while it is true)
+		struct Watch {
+			std::uint32_t clause;
+			literal_t blocker;
+		};
+
+		//! long clauses one after another: size, learned flag, activity (float bits) and literals
+		//! (the literals at positions 0 and 1 are watched, an implied literal is at position 0)
+		std::vector<std::uint32_t> _arena;
+		std::vector<std::uint32_t> _learned;
+		std::size_t _original_clauses = 0;
+		std::size_t _binary_clauses = 0;
+		std::size_t _max_learned;
+		float _clause_increment = 1;
+
+		//! watches per literal (visited when it becomes false)
+		std::vector<std::vector<Watch>> _watches;
+
+		std::vector<std::uint8_t> _assigns;
+		std::vector<std::uint8_t> _phases;
+		std::vector<std::uint32_t> _levels;
+		std::vector<std::uint32_t> _reasons;
+		std::vector<literal_t> _trail;
+		//! start of each decision level in the trail
+		std::vector<std::size_t> _level_starts;
+		std::size_t _head = 0;
+		bool _unsatisfiable = false;
+		//! false literal of a conflicting binary clause (the conflict holds the other one)
+		literal_t _conflict_literal = 0;
+
+		//! activities and the heap of unassigned variables ordered by them
+		std::vector<double> _activities;
+		double _variable_increment = 1;
+		std::vector<variable_t> _heap;
+		std::vector<std::int32_t> _heap_positions;
+
+		//! flags and buffers of the conflict analysis
+		std::vector<std::uint8_t> _seen;
+		std::vector<literal_t> _learned_literals;
+		std::vector<literal_t> _analyzed;
+
+		Stats _stats;
+
+		std::uint8_t _value(literal_t l) const {
+			std::uint8_t a = _assigns[l >> 1];
+			return a == undefined ? undefined : std::uint8_t(a ^ (l & 1));
+		}
+		std::uint32_t _level() const {return std::uint32_t(_level_starts.size());}
+		std::uint32_t _size(std::uint32_t clause) const {return _arena[clause];}
+		literal_t* _literals(std::uint32_t clause) {return &_arena[clause + 3];}
+		float _activity(std::uint32_t clause) const;
+		void _set_activity(std::uint32_t clause, float activity);
+
+		//! stores a clause with at least two literals and watches its first two literals
+		//! @return reference of the clause (no_reason for binary clauses)
+		std::uint32_t _attach(const std::vector<literal_t>& literals, bool learned);
+		void _assign(literal_t l, std::uint32_t reason);
+		//! @return the conflicting clause or no_reason
+		std::uint32_t _propagate();
+		//! analyzes the conflict into _learned_literals (the asserting literal first)
+		//! @return level to jump back to
+		std::uint32_t _analyze(std::uint32_t conflict);
+		//! @return true if the literal is implied by other literals of the learned clause
+		bool _redundant(literal_t l);
+		void _backtrack(std::uint32_t level);
+		//! @return next decision or the number of variables times two if all are assigned
+		literal_t _decide();
+		//! drops the less active half of the learned clauses and compacts the arena
+		void _reduce();
+
+		void _bump(variable_t v);
+		void _bump_clause(std::uint32_t clause);
+		void _heap_insert(variable_t v);
+		void _heap_up(std::size_t i);
+		void _heap_down(std::size_t i);
+		variable_t _heap_pop();
+	};
+
+	//! solves the grid via its CNF encoding with Sat_Solver
+	//! Each cell has a variable per value which is possible after cancelling the givens in their peers.
+	//! The clauses require at least one value per cell, at least one cell per value and unit and at most one
+	//! value per cell and cell per value and unit (pairwise). The limits apply with assumptions being decisions.
+	//! The statistics report decisions as assumptions, propagated literals as propagation rounds, learned
+	//! clauses as learned nogoods and the highest decision level as maximal depth.
+	//! Solutions are counted (see Search_Options::solution_limit) by excluding each model found.
+	Solve_Result solve_sat(const Single_Value_Sudoku_Grid& sg_start, const Grid_Layout& layout,
+						   const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options());
+
+}
+
+#endif /* Sat_h */
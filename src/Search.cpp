@@ -0,0 +1,861 @@
+//
+//  Search.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Search.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include "util.h"
+
+using namespace sudoku_solver;
+
+// synopsis:
+//
+// step I: (analytical part)
+//
+//    a: find cells with one possibility only and finalize them
+//    a.a: find non-final cells with only one possibility
+//        for each such cell:
+//            mark the value as used for its units (box resp. region, lines and diagonals if any)
+//            mark it as final
+//    a.b: find single occurrence of a value in a unit
+//        mark those cells as final
+//    (Both sub-steps might return with a contradiction.)
+//
+//    b: cancel possibilities
+//    b.a: cancel no longer possible values form all cells via marked-as-used values per unit
+//    b.b: cancles possibilities due to 'blocking' of a value whose position in one box is fixed to one line
+//         (resp. in one region or to one diagonal)
+//         (The position of the value is known for the line in one direction. It can be treated as if a final
+//          value cancled the possibility of this value in the same line inside the other boxes.)
+//         and vice versa of a value whose position in one line is fixed to one box
+//         (Only boxes which changed since their last reduction are analyzed.)
+//
+//
+// step II: (assumption based part)
+//
+//    for each possibility in a non-final cell:
+//        apply the solving algorithm with just this one possibility cancled out
+//        (the choice point is pushed onto the stack and all changes are recorded in the undo log)
+//        revert all changes if a contradiction occurs and continue with the next possibility
+//    (This brute force method complements the analytical step and is necessary for ambigous sudokus.)
+//
+
+Search_Engine::Search_Engine(Multiple_Value_Sudoku_Grid mg_start, const Solve_Limits& limits, const Search_Options& options)
+: _layout(Grid_Layout::standard(mg_start.size())), _grid(std::move(mg_start)), _limits(limits)
+{
+	_init(options);
+}
+
+Search_Engine::Search_Engine(Multiple_Value_Sudoku_Grid mg_start, const Grid_Layout& layout,
+							 const Solve_Limits& limits, const Search_Options& options)
+: _layout(layout), _grid(std::move(mg_start)), _limits(limits)
+{
+	_init(options);
+}
+
+void Search_Engine::_init(const Search_Options& options) {
+
+	const std::size_t n = _grid.size();
+
+	_sections.resize(_layout.units());
+	// lines crossing each box resp. region
+	_box_line_offsets.assign(1, 0);
+	std::size_t max_lines = 0;
+	for (std::uint32_t b = 0; b < _layout.units(); ++b) {
+		if (_layout.kind(b) == Unit_Kind::box || _layout.kind(b) == Unit_Kind::region) {
+			std::size_t first = _box_lines.size();
+			const cell_index_t* box_cells = _layout.unit_cells(b);
+			for (unsigned int k = 0; k < n; ++k) {
+				const std::uint32_t* units = _layout.cell_units(box_cells[k]);
+				for (std::uint32_t i = 0; i < _layout.cell_unit_count(box_cells[k]); ++i) {
+					if (units[i] != b && std::find(_box_lines.begin() + first, _box_lines.end(), units[i]) == _box_lines.end())
+						_box_lines.push_back(units[i]);
+				}
+			}
+			max_lines = std::max(max_lines, _box_lines.size() - first);
+		}
+		_box_line_offsets.push_back(std::uint32_t(_box_lines.size()));
+	}
+	_line_slots.resize(_layout.units());
+	_intersections.resize(max_lines * n);
+	// all boxes are reduced in the first round
+	_changed.assign(_layout.units(), _stamp);
+	_reduced.assign(_layout.units(), 0);
+
+	for (auto& s : _sections)
+		s.reserve(n);
+
+	// flat access to the cells (the rows of the grid are never reallocated)
+	for (unsigned int x = 0; x < n; ++x) {
+		for (unsigned int y = 0; y < n; ++y)
+			_cells.push_back(&_grid.get_cell(x, y));
+	}
+
+	// each possibility is removed at most once per path of the search tree
+	_trail.reserve(n * n * n + 4 * n * n);
+	_stack.reserve(n * n);
+
+	if (options.nogood_capacity != 0) {
+		_nogoods.reset(new Nogood_Store(n * n * n, options.nogood_capacity, options.nogood_size));
+		_pending.reserve(n * n * n);
+	}
+
+	if (options.transposition_memory != 0) {
+		_keys.reset(new Zobrist_Keys(n));
+		_transpositions.reset(new Transposition_Table(options.transposition_memory));
+		for (cell_index_t c = 0; c < n * n; ++c) {
+			for (value_t v = 1; v <= n; ++v) {
+				if (!has_value(_cells[c]->get_values(), v))
+					_hash ^= _keys->key(c, v);
+			}
+		}
+	}
+
+	_unit_counts.assign(_layout.units() * n, 0);
+	for (cell_index_t c = 0; c < n * n; ++c) {
+		if (_cells[c]->is_final())
+			++_final_cells;
+		_candidates += _cells[c]->possibilities();
+		const std::uint32_t* units = _layout.cell_units(c);
+		for (value_t v : _cells[c]->get_values()) {
+			for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i)
+				++_unit_counts[units[i] * n + v - 1];
+		}
+	}
+
+	_branching = options.branching;
+	_seed = options.seed;
+	_restart_interval = options.restart_interval;
+	_solution_limit = options.solution_limit;
+	_tracer = options.tracer;
+	_cell_ranks.resize(n * n);
+	_value_ranks.resize(n + 1);
+	for (cell_index_t c = 0; c < n * n; ++c)
+		_max_peers = std::max(_max_peers, _layout.peer_count(c));
+	_shuffle();
+}
+
+bool Search_Engine::run(unsigned long assumptions) {
+
+	if (_finished)
+		return true;
+
+	auto start = std::chrono::steady_clock::now();
+
+	if (!_started) {
+		_started = true;
+		_deadline = start + _limits.time;
+		if (_tracer)
+			_trace_search();
+
+		if (!_propagate()) {
+			// the grid is kept in the state in which the contradiction was detected
+			if (!_finished)
+				_finish(Solve_Status::contradiction, _reason);
+		} else if (!_not_final) {
+			// a grid solved by step I has no other solution
+			++_stats.solutions;
+			_finish(Solve_Status::solved, "solved");
+		} else {
+			_push();
+		}
+	}
+
+	const unsigned long assumptions_end = _stats.assumptions + assumptions;
+
+	while (!_finished) {
+
+		// suspend
+		if (assumptions != 0 && _stats.assumptions >= assumptions_end)
+			break;
+
+		if (_restart_due())
+			_restart();
+
+		Choice& c = _stack.back();
+
+		if (!_next_choice(c)) {
+			// all assumptions of this choice point lead to contradictions
+			_refuted(c);
+			_stack.pop_back();
+			if (_stack.empty()) {
+				// the grid is in the state after step I of the top level
+				_exhausted();
+			} else {
+				// the assumption which lead to the choice point fails
+				_fail_assumption(Trace_Outcome::refuted);
+			}
+			continue;
+		}
+
+		if (_limits.assumptions != 0 && _stats.assumptions >= _limits.assumptions) {
+			_finish(Solve_Status::assumption_limit, to_string(Solve_Status::assumption_limit));
+			_undo(_stack.front().trail_mark);
+			break;
+		}
+		++_stats.assumptions;
+		if (_stack.size() > _stats.max_depth)
+			_stats.max_depth = (unsigned int) _stack.size();
+
+		// cancel one value by pure assumption
+		if (_tracer)
+			_trace_assumption(c);
+		_remove(c.cell, c.value);
+
+		if (_propagate()) {
+			if (!_not_final) {
+				// counted solutions are treated like contradictions
+				if (!_solution_found())
+					_fail_assumption(Trace_Outcome::solved);
+			} else if (_transpositions && _transpositions->contains(_hash)) {
+				// reached before by another order of assumptions
+				++_stats.transposition_hits;
+				_fail_assumption(Trace_Outcome::transposition);
+			} else {
+				_push();
+			}
+		} else if (_finished) {
+			// interrupted: return the state without any assumption
+			_undo(_stack.front().trail_mark);
+		} else {
+			// contradiction: revert the assumption
+			_fail_assumption(Trace_Outcome::contradiction);
+		}
+	}
+
+	_stats.time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	return _finished;
+}
+
+double Search_Engine::progress() const {
+	if (_finished)
+		return 1.0;
+
+	// each choice point divides the remaining part of the tree equally among its possible assumptions
+	double explored = 0.0;
+	double weight = 1.0;
+	for (const Choice& c : _stack) {
+		if (c.choices == 0)
+			break;
+		if (c.ordinal > 0)
+			explored += weight * (c.ordinal - 1) / c.choices;
+		weight /= c.choices;
+	}
+	return explored;
+}
+
+Solve_Result Search_Engine::result() {
+	return {std::move(_grid), _status, _reason, _stats};
+}
+
+bool Search_Engine::_remove(cell_index_t c, value_t v) {
+	if (!removed(_cells[c]->get_values(), v))
+		return false;
+	_trail.push_back({Change::removed_value, c, v});
+	_count(c, v, -1);
+	++_stamp;
+	const std::uint32_t* units = _layout.cell_units(c);
+	for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i)
+		_changed[units[i]] = _stamp;
+	if (_nogoods)
+		_pending.push_back(c * _layout.size() + v - 1);
+	if (_keys)
+		_hash ^= _keys->key(c, v);
+	return true;
+}
+
+void Search_Engine::_count(cell_index_t c, value_t v, int delta) {
+	_candidates += delta;
+	const std::uint32_t* units = _layout.cell_units(c);
+	for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i)
+		_unit_counts[units[i] * _layout.size() + v - 1] += delta;
+}
+
+void Search_Engine::_make_final(cell_index_t c) {
+	_cells[c]->make_final();
+	++_final_cells;
+	_trail.push_back({Change::made_final, c, 0});
+}
+
+bool Search_Engine::_use(std::uint32_t unit, value_t v) {
+	std::vector<value_t>& s = _sections[unit];
+	if (has_value(s, v))
+		return false;
+	s.push_back(v);
+	_trail.push_back({Change::used_value, unit, v});
+	return true;
+}
+
+bool Search_Engine::_use_in_all_units(cell_index_t c, value_t v) {
+	const std::uint32_t* units = _layout.cell_units(c);
+	for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i) {
+		if (!_use(units[i], v)) {
+			_reason = std::string("same value in ") + to_string(_layout.kind(units[i]));
+			return false;
+		}
+	}
+	return true;
+}
+
+void Search_Engine::_undo(std::size_t trail_mark) {
+	while (_trail.size() > trail_mark) {
+		const Change& c = _trail.back();
+		switch (c.kind) {
+			case Change::removed_value:
+				_cells[c.index]->get_values().push_back(c.value);
+				_count(c.index, c.value, 1);
+				if (_keys)
+					_hash ^= _keys->key(c.index, c.value);
+				break;
+			case Change::made_final:
+				_cells[c.index]->make_non_final();
+				--_final_cells;
+				break;
+			case Change::used_value:
+				_sections[c.index].pop_back();
+				break;
+		}
+		_trail.pop_back();
+	}
+	_pending.clear();
+}
+
+bool Search_Engine::_propagate() {
+
+	const unsigned int n = _layout.size();
+	const cell_index_t cells = _layout.cells();
+
+	// tracks the amount of removed possibilities (if it differs from 0 step I is repeated)
+	unsigned int removed_possibilities;
+
+	// step I: analyze and cancle possibilities
+	do {
+		// stop on timeout or cancellation
+		if (_interrupted())
+			return false;
+		++_stats.propagation_rounds;
+
+		removed_possibilities = 0;
+
+		// Ia: analyze cells for final values (via all units)
+
+		// Ia.a: find cell with one possible value left which is not marked as final
+		for (cell_index_t c = 0; c < cells; ++c) {
+
+			Multiple_Value_Cell& cell = *_cells[c];
+
+			if (!cell.is_final() && cell.possibilities() == 1) {
+
+				// check for contradictions and stop if one occurred
+				// or store final value as 'used' in all units and continue
+				if (!_use_in_all_units(c, cell.get_values()[0]))
+					return false;
+
+				// mark cell as final
+				_make_final(c);
+			}
+		}
+
+		// Ia.b: find single occurrence of a value in a unit
+
+		// for each value
+		for (value_t v = 1; v <= n; ++v) {
+
+			// for each unit (lines in x-direction, lines in y-direction, boxes resp. regions, diagonals)
+			for (std::size_t u = 0; u < _layout.units(); ++u) {
+
+				// the value v must occur just once in this unit and not as final value
+				// (only then the unit is searched for its cell)
+				if (_unit_counts[u * n + v - 1] != 1 || has_value(_sections[u], v))
+					continue;
+
+				// stores the position of that cell
+				cell_index_t cell_pos = 0;
+
+				const cell_index_t* unit_cells = _layout.unit_cells(u);
+				for (unsigned int k = 0; k < n; ++k) {
+					if (has_value(_cells[unit_cells[k]]->get_values(), v)) {
+						cell_pos = unit_cells[k];
+						break;
+					}
+				}
+
+				// check for contradictions and stop if one occurred
+				// or store final value as used in all units and continue
+				if (!_use_in_all_units(cell_pos, v))
+					return false;
+
+				// cancel all other possible values for this cell
+				std::vector<value_t> others = _cells[cell_pos]->get_values();
+				for (value_t w : others) {
+					if (w != v)
+						_remove(cell_pos, w);
+				}
+				// mark cell as final
+				_make_final(cell_pos);
+			}
+		}
+
+		// Ib.a: cancel no longer possible values (due to final values)
+		for (cell_index_t c = 0; c < cells; ++c) {
+
+			Multiple_Value_Cell& cell = *_cells[c];
+
+			// find non-final cell
+			if (!cell.is_final()) {
+
+				// try to remove the values stored as used in all units corresponding to the current cell
+				// if the remove was possible increment the counter
+				const std::uint32_t* units = _layout.cell_units(c);
+				for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i) {
+					for (value_t v : _sections[units[i]]) {
+						if (_remove(c, v))
+							++removed_possibilities;
+					}
+				}
+
+				// if one cell is empty the grid contains a contradiction
+				if (cell.is_empty()) {
+					_reason = "no possible value for cell";
+					return false;
+				}
+			}
+		}
+
+		// Ib.b cancles possibilities due to 'blocking' of a value whose position in a box (resp. region) is fixed
+		// to one line (resp. diagonal) or whose position in a line is fixed to one box
+		// apply this for each box which changed (undoing changes restores a state in which all boxes were reduced)
+		for (std::uint32_t b = 0; b < _layout.units(); ++b) {
+
+			if (_layout.kind(b) != Unit_Kind::box && _layout.kind(b) != Unit_Kind::region)
+				continue;
+
+			bool changed = _changed[b] > _reduced[b];
+			for (std::uint32_t i = _box_line_offsets[b]; !changed && i < _box_line_offsets[b + 1]; ++i)
+				changed = _changed[_box_lines[i]] > _reduced[b];
+			if (changed)
+				_reduce_box(b, removed_possibilities);
+		}
+
+		// Ic: finalize values implied by learned nogoods
+		if (_nogoods && !_propagate_nogoods(removed_possibilities))
+			return false;
+
+#if DEBUG
+		print_grid(std::cout, _grid);
+		std::cout << std::endl << std::endl;
+#endif
+	// continue until analyzing and canceling results in no changes
+	} while (removed_possibilities != 0);
+
+	// decides whether step II is applied
+	_not_final = _final_cells < cells;
+	return true;
+}
+
+void Search_Engine::_reduce_box(std::uint32_t b, unsigned int& removed_possibilities) {
+
+	const unsigned int n = _layout.size();
+	const std::uint32_t* lines = &_box_lines[_box_line_offsets[b]];
+	const std::uint32_t line_count = _box_line_offsets[b + 1] - _box_line_offsets[b];
+	const cell_index_t* box_cells = _layout.unit_cells(b);
+
+	// changes made from here on are seen by the next round
+	_reduced[b] = _stamp;
+
+	// count the cells of the box with a possible value per crossing line
+	for (std::uint32_t i = 0; i < line_count; ++i)
+		_line_slots[lines[i]] = i;
+	std::fill(_intersections.begin(), _intersections.begin() + line_count * n, 0);
+	for (unsigned int k = 0; k < n; ++k) {
+		const Multiple_Value_Cell& cell = *_cells[box_cells[k]];
+		if (cell.is_final())
+			continue;
+		const std::uint32_t* units = _layout.cell_units(box_cells[k]);
+		for (std::uint32_t i = 0; i < _layout.cell_unit_count(box_cells[k]); ++i) {
+			if (units[i] == b)
+				continue;
+			std::uint32_t* counts = &_intersections[_line_slots[units[i]] * n];
+			for (value_t v : cell.get_values())
+				++counts[v - 1];
+		}
+	}
+
+	for (value_t v = 1; v <= n; ++v) {
+
+		// final values are cancelled in their units by Ib.a
+		const std::uint32_t in_box = _unit_counts[b * n + v - 1];
+		if (in_box < 2)
+			continue;
+
+		for (std::uint32_t i = 0; i < line_count; ++i) {
+
+			const std::uint32_t line = lines[i];
+			const std::uint32_t in_both = _intersections[i * n + v - 1];
+			const std::uint32_t in_line = _unit_counts[line * n + v - 1];
+			if (in_both == 0)
+				continue;
+
+			// pointing: remove v from each cell in this line except the cells in this box
+			if (in_both == in_box && in_line > in_both) {
+				const cell_index_t* line_cells = _layout.unit_cells(line);
+				for (unsigned int k = 0; k < n; ++k) {
+					if (!_layout.contains(b, line_cells[k]) && _remove(line_cells[k], v))
+						++removed_possibilities;
+				}
+			}
+
+			// claiming: remove v from each cell in this box except the cells in this line
+			// (the counts of the other lines are outdated afterwards)
+			if (in_both == in_line && in_box > in_both) {
+				for (unsigned int k = 0; k < n; ++k) {
+					if (!_layout.contains(line, box_cells[k]) && _remove(box_cells[k], v))
+						++removed_possibilities;
+				}
+				break;
+			}
+		}
+	}
+}
+
+bool Search_Engine::_propagate_nogoods(unsigned int& removed_possibilities) {
+
+	const unsigned int n = _layout.size();
+
+	// a literal is true if the value is no longer possible for the cell
+	auto is_true = [this, n](Nogood_Store::literal_t l) {
+		return !has_value(_cells[l / n]->get_values(), value_t(l % n + 1));
+	};
+
+	// (the queue grows while implied values are finalized)
+	for (std::size_t i = 0; i < _pending.size(); ++i) {
+
+		_implied.clear();
+		if (!_nogoods->propagate(_pending[i], is_true, _implied)) {
+			_reason = "learned contradiction";
+			return false;
+		}
+
+		for (Nogood_Store::literal_t l : _implied) {
+			cell_index_t c = l / n;
+			value_t v = value_t(l % n + 1);
+			if (is_true(l)) {
+				_reason = "learned contradiction";
+				return false;
+			}
+
+			// cancel all other possible values for this cell
+			std::vector<value_t> others = _cells[c]->get_values();
+			for (value_t w : others) {
+				if (w != v && _remove(c, w))
+					++removed_possibilities;
+			}
+			++_stats.nogood_implications;
+		}
+	}
+	_pending.clear();
+	return true;
+}
+
+bool Search_Engine::_next_choice(Choice& c) {
+
+	const std::uint32_t n = _grid.size();
+
+	// for each possibility to cancle a non-final value find the smallest (key, cell rank, value rank)
+	// larger than the last one (the keys do not change while a choice point is active because its grid
+	// is restored before each assumption)
+	auto order = [this](std::uint64_t key, cell_index_t cell, value_t value) {
+		return (key << 40) | (std::uint64_t(_cell_ranks[cell]) << 16) | _value_ranks[value];
+	};
+	const bool started = c.ordinal != 0;
+	const std::uint64_t last = started ? order(c.key, c.cell, c.value) : 0;
+	std::uint64_t next = UINT64_MAX;
+
+	for (cell_index_t i = 0; i < n * n; ++i) {
+
+		const Multiple_Value_Cell& cell = *_cells[i];
+		if (cell.possibilities() < 2)
+			continue;
+
+		const std::uint32_t cell_key = _cell_key(i);
+		for (value_t v : cell.get_values()) {
+
+			std::uint32_t key = cell_key;
+			if (_branching == Branching::constraint) {
+				const std::uint32_t* units = _layout.cell_units(i);
+				for (std::uint32_t k = 0; k < _layout.cell_unit_count(i); ++k)
+					key = std::min(key, _unit_counts[units[k] * n + v - 1]);
+			}
+
+			std::uint64_t o = order(key, i, v);
+			if ((!started || o > last) && o < next) {
+				next = o;
+				c.key = key;
+				c.cell = i;
+				c.value = v;
+			}
+		}
+	}
+
+	if (next == UINT64_MAX)
+		return false;
+	++c.ordinal;
+	return true;
+}
+
+std::uint32_t Search_Engine::_cell_key(cell_index_t c) const {
+
+	std::uint32_t possibilities = std::uint32_t(_cells[c]->possibilities());
+	if (_branching != Branching::degree)
+		return possibilities;
+
+	// cells with more non-final peers restrict more cells by their assumptions
+	std::uint32_t open = 0;
+	const cell_index_t* peers = _layout.peers(c);
+	for (std::uint32_t k = 0; k < _layout.peer_count(c); ++k) {
+		if (_cells[peers[k]]->possibilities() > 1)
+			++open;
+	}
+	return possibilities * (_max_peers + 1) + (_max_peers - open);
+}
+
+void Search_Engine::_shuffle() {
+
+	for (std::size_t i = 0; i < _cell_ranks.size(); ++i)
+		_cell_ranks[i] = std::uint32_t(i);
+	for (std::size_t v = 0; v < _value_ranks.size(); ++v)
+		_value_ranks[v] = std::uint32_t(v);
+
+	if (_branching == Branching::random) {
+		// each restart uses another order
+		std::mt19937_64 random {_seed + _stats.restarts};
+		std::shuffle(_cell_ranks.begin(), _cell_ranks.end(), random);
+		std::shuffle(_value_ranks.begin() + 1, _value_ranks.end(), random);
+	}
+}
+
+bool Search_Engine::_restart_due() const {
+	// counting solutions relies on the order of the search
+	if (_restart_interval == 0 || _solution_limit != 1 || _stack.size() < 2)
+		return false;
+	// the growing intervals keep the search complete
+	return _stats.assumptions - _restart_mark >= _restart_interval * luby(_stats.restarts + 1);
+}
+
+void Search_Engine::_restart() {
+
+	while (_traced_depth != 0)
+		_trace_end(Trace_Outcome::restart);
+	_undo(_stack.front().trail_mark);
+	_stack.resize(1);
+
+	Choice& c = _stack.front();
+	c.key = 0;
+	c.cell = 0;
+	c.value = 0;
+	c.ordinal = 0;
+
+	++_stats.restarts;
+	_restart_mark = _stats.assumptions;
+	_shuffle();
+}
+
+void Search_Engine::_push() {
+
+	Choice c;
+	c.trail_mark = std::uint32_t(_trail.size());
+	c.choices = _count_choices();
+	c.hash = _hash;
+	c.assumptions = _stats.assumptions;
+
+	_stack.push_back(c);
+
+	std::size_t memory = _memory();
+	if (memory > _stats.peak_memory)
+		_stats.peak_memory = memory;
+	if (_limits.memory != 0 && memory > _limits.memory) {
+		_finish(Solve_Status::memory_limit, to_string(Solve_Status::memory_limit));
+		_undo(_stack.front().trail_mark);
+	}
+}
+
+void Search_Engine::_fail_assumption(Trace_Outcome outcome) {
+
+	const unsigned int n = _layout.size();
+
+	while (true) {
+
+		Choice& c = _stack.back();
+		if (_tracer)
+			_trace_end(outcome, _trail.size() - c.trail_mark);
+		// the assumptions of the parents fail since all of their assumptions failed
+		outcome = Trace_Outcome::refuted;
+		_undo(c.trail_mark);
+
+		// (counting solutions needs disjoint branches, hence the value is finalized even without learning)
+		if (!_nogoods && _solution_limit == 1)
+			return;
+
+		// the assumptions of all lower choice points together with cancelling c.value from c.cell
+		// lead to a contradiction
+		if (_nogoods) {
+			_learned.clear();
+			for (std::size_t k = 0; k + 1 < _stack.size(); ++k)
+				_learned.push_back(_stack[k].cell * n + _stack[k].value - 1);
+			_learned.push_back(c.cell * n + c.value - 1);
+			if (_nogoods->add(_learned))
+				++_stats.learned_nogoods;
+		}
+
+		// hence the value is final for this cell under the active assumptions
+		std::vector<value_t> others = _cells[c.cell]->get_values();
+		for (value_t w : others) {
+			if (w != c.value)
+				_remove(c.cell, w);
+		}
+
+		if (_propagate()) {
+			if (!_not_final) {
+				// the choice point has no further solution if this one is counted
+				if (_solution_found())
+					return;
+			} else {
+				// start over with the reduced grid
+				c.trail_mark = std::uint32_t(_trail.size());
+				c.cell = 0;
+				c.value = 0;
+				c.key = 0;
+				c.ordinal = 0;
+				c.choices = _count_choices();
+				return;
+			}
+		} else if (_finished) {
+			// interrupted: return the state without any assumption
+			_undo(_stack.front().trail_mark);
+			return;
+		}
+
+		// the choice point itself contains a contradiction
+		_refuted(c);
+		_undo(c.trail_mark);
+		_stack.pop_back();
+		if (_stack.empty()) {
+			_exhausted();
+			return;
+		}
+	}
+}
+
+bool Search_Engine::_solution_found() {
+
+	++_stats.solutions;
+	if (_solution_limit != 0 && _stats.solutions >= _solution_limit) {
+		_finish(Solve_Status::solved, "solved");
+		return true;
+	}
+
+	// keep the first solution and continue the search
+	if (_stats.solutions == 1)
+		_solution.reset(new Multiple_Value_Sudoku_Grid(_grid));
+	return false;
+}
+
+void Search_Engine::_exhausted() {
+	if (_stats.solutions == 0) {
+		_finish(Solve_Status::contradiction, "no possibility left");
+		return;
+	}
+	// all solutions were counted
+	_grid = *_solution;
+	_finish(Solve_Status::solved, "solved");
+}
+
+std::uint32_t Search_Engine::_count_choices() const {
+	std::uint32_t choices = 0;
+	for (std::uint32_t i = 0; i < _grid.size() * _grid.size(); ++i) {
+		std::size_t p = _cells[i]->possibilities();
+		if (p > 1)
+			choices += std::uint32_t(p);
+	}
+	return choices;
+}
+
+void Search_Engine::_refuted(const Choice& c) {
+	if (_transpositions)
+		_transpositions->insert(c.hash, std::uint32_t(std::min<unsigned long>(_stats.assumptions - c.assumptions, UINT32_MAX)));
+}
+
+void Search_Engine::_trace_search() {
+	Trace_Event e;
+	e.kind = Trace_Event::search_begin;
+	e.value = std::uint16_t(_layout.size());
+	e.assumptions = _stats.assumptions;
+	e.propagation_rounds = _stats.propagation_rounds;
+	_tracer->record(e);
+}
+
+void Search_Engine::_trace_assumption(const Choice& c) {
+	Trace_Event e;
+	e.kind = Trace_Event::assumption_begin;
+	e.cell = c.cell;
+	e.value = std::uint16_t(c.value);
+	e.depth = ++_traced_depth;
+	e.assumptions = _stats.assumptions;
+	e.propagation_rounds = _stats.propagation_rounds;
+	_tracer->record(e);
+}
+
+void Search_Engine::_trace_end(Trace_Outcome outcome, std::size_t changes) {
+	// the begin of assumptions made before resuming a checkpoint is not recorded
+	if (_traced_depth == 0)
+		return;
+	Trace_Event e;
+	e.kind = Trace_Event::assumption_end;
+	e.outcome = outcome;
+	e.depth = _traced_depth--;
+	e.changes = std::uint32_t(changes);
+	e.assumptions = _stats.assumptions;
+	e.propagation_rounds = _stats.propagation_rounds;
+	_tracer->record(e);
+}
+
+bool Search_Engine::_interrupted() {
+	if (_limits.cancellation && _limits.cancellation->cancelled())
+		_finish(Solve_Status::cancelled, to_string(Solve_Status::cancelled));
+	else if (_limits.time.count() != 0 && std::chrono::steady_clock::now() >= _deadline)
+		_finish(Solve_Status::timeout, to_string(Solve_Status::timeout));
+	return _finished;
+}
+
+void Search_Engine::_finish(Solve_Status status, const std::string& reason) {
+	_finished = true;
+	_status = status;
+	_reason = reason;
+
+	if (_tracer) {
+		Trace_Outcome outcome = status == Solve_Status::solved ? Trace_Outcome::solved : Trace_Outcome::interrupted;
+		while (_traced_depth != 0)
+			_trace_end(outcome);
+		Trace_Event e;
+		e.kind = Trace_Event::search_end;
+		e.outcome = status == Solve_Status::contradiction ? Trace_Outcome::contradiction : outcome;
+		e.assumptions = _stats.assumptions;
+		e.propagation_rounds = _stats.propagation_rounds;
+		_tracer->record(e);
+	}
+}
+
+std::size_t Search_Engine::_memory() const {
+	const std::size_t n = _grid.size();
+	return n * n * (sizeof(Multiple_Value_Cell) + sizeof(Multiple_Value_Cell*) + n * sizeof(value_t))
+		 + _sections.size() * n * sizeof(value_t)
+		 + _trail.size() * sizeof(Change)
+		 + _stack.size() * sizeof(Choice);
+}
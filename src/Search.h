@@ -0,0 +1,255 @@
+//
+//  Search.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Search_h
+#define Search_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include "solve.h"
+#include "Layout.h"
+#include "Nogoods.h"
+#include "Transposition.h"
+#include "Trace.h"
+
+namespace sudoku_solver {
+
+	//! iterative implementation of the solving algorithm
+	//! Instead of copying the grid per assumption all changes are recorded in an undo log (trail)
+	//! and the assumptions are kept on an explicit (preallocated) stack of compact choice records.
+	//! The search can be suspended and resumed (see run) and inspected in between.
+	class Search_Engine {
+
+	public:
+		//! @param mg_start grid with all possible values per cell (see create_possibility_grid)
+		Search_Engine(Multiple_Value_Sudoku_Grid mg_start, const Solve_Limits& limits = Solve_Limits(),
+					  const Search_Options& options = Search_Options());
+		//! @param layout units of the grid (must outlive the engine)
+		Search_Engine(Multiple_Value_Sudoku_Grid mg_start, const Grid_Layout& layout,
+					  const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options());
+		//! resumes a search saved via save
+		//! @param checkpoint stream positioned after the header (see read_header)
+		//! @param layout layout returned by read_header (must outlive the engine)
+		//! @throws std::runtime_error if the checkpoint is truncated or invalid
+		Search_Engine(std::istream& checkpoint, const Grid_Layout& layout,
+					  const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options());
+		Search_Engine(const Search_Engine&) = delete;
+		Search_Engine& operator=(const Search_Engine&) = delete;
+
+		//! continues the search until it ends or the given amount of further assumptions was made
+		//! @param assumptions maximal amount of assumptions made by this call (zero means unlimited)
+		//! @return true if the search has ended
+		bool run(unsigned long assumptions = 0);
+
+		bool finished() const {return _finished;}
+		//! @return amount of active assumptions
+		std::size_t depth() const {return _stack.empty() ? 0 : _stack.size() - 1;}
+		//! @return estimate of the explored fraction of the search tree (between 0 and 1)
+		double progress() const;
+
+		//! @return the current state of the grid (contains the active assumptions)
+		const Multiple_Value_Sudoku_Grid& grid() const {return _grid;}
+		//! @return amount of final cells of the current grid
+		cell_index_t final_cells() const {return _final_cells;}
+		//! @return amount of possible values of all cells of the current grid
+		std::size_t candidates() const {return _candidates;}
+		const Solve_Stats& stats() const {return _stats;}
+		//! @return status of the finished search
+		Solve_Status status() const {return _status;}
+		//! @return reason why the search has ended
+		const std::string& reason() const {return _reason;}
+
+		//! @return result of the finished search (the grid is moved out of the engine)
+		Solve_Result result();
+
+		//! writes the state of the (suspended) search as binary checkpoint
+		//! (The grid, the undo log, the choice points and the statistics are saved. Learned nogoods and
+		//! refuted grids are not, they are learned again after resuming.
+		//! The search continues in the same order only if the same branching options are given.)
+		void save(std::ostream& os) const;
+		//! reads the header of a checkpoint
+		//! @return layout of the saved search
+		//! @throws std::runtime_error if the stream does not contain a checkpoint
+		static std::unique_ptr<Grid_Layout> read_header(std::istream& is);
+
+	private:
+
+		//! entry of the undo log
+		struct Change {
+			enum Kind : std::uint8_t {removed_value, made_final, used_value};
+			Kind kind;
+			//! cell index resp. unit index
+			std::uint32_t index;
+			value_t value;
+		};
+
+		//! choice point of step II: the assumption currently made in a propagated grid
+		struct Choice {
+			//! size of the undo log before the assumption
+			std::uint32_t trail_mark;
+			//! cell and value removed by the assumption
+			cell_index_t cell = 0;
+			value_t value = 0;
+			//! assumptions are made in ascending order of (key, rank of the cell, rank of the value)
+			//! (the key depends on the branching order, e.g. the amount of possibilities of the cell)
+			std::uint32_t key = 0;
+			//! amount of assumptions made resp. possible at this choice point (used for progress estimation)
+			std::uint32_t ordinal = 0;
+			std::uint32_t choices = 0;
+			//! hash of the grid and amount of assumptions made before the choice point was opened
+			std::uint64_t hash = 0;
+			unsigned long assumptions = 0;
+		};
+
+		const Grid_Layout& _layout;
+		Multiple_Value_Sudoku_Grid _grid;
+		//! cell per cell index
+		std::vector<Multiple_Value_Cell*> _cells;
+		//! final values per unit
+		std::vector<std::vector<value_t>> _sections;
+		//! lines (and diagonals) crossing each box resp. region (see _box_line_offsets, empty for other units)
+		std::vector<std::uint32_t> _box_lines;
+		std::vector<std::uint32_t> _box_line_offsets;
+		//! buffers for the box-line reduction: position of a unit in the lines of the current box
+		//! and amount of cells of the box with a possible value per crossing line and value
+		std::vector<std::uint32_t> _line_slots;
+		std::vector<std::uint32_t> _intersections;
+		//! stamp of the last removal per unit resp. of the last box-line reduction per box
+		//! (a box is only reduced again if it or one of its crossing lines changed since)
+		std::uint64_t _stamp = 1;
+		std::vector<std::uint64_t> _changed;
+		std::vector<std::uint64_t> _reduced;
+		std::vector<Change> _trail;
+		std::vector<Choice> _stack;
+
+		//! counters kept up to date by _remove, _make_final and _undo
+		cell_index_t _final_cells = 0;
+		std::size_t _candidates = 0;
+		//! amount of cells in which a value is possible per unit and value (unit * size + value - 1)
+		std::vector<std::uint32_t> _unit_counts;
+
+		//! learned nogoods (only if enabled by the options)
+		std::unique_ptr<Nogood_Store> _nogoods;
+		//! literals which became true but were not yet checked against the nogoods
+		std::vector<Nogood_Store::literal_t> _pending;
+		//! buffers for the nogood propagation resp. analysis
+		std::vector<Nogood_Store::literal_t> _implied;
+		std::vector<Nogood_Store::literal_t> _learned;
+
+		//! hashes of refuted grids (only if enabled by the options)
+		std::unique_ptr<Zobrist_Keys> _keys;
+		std::unique_ptr<Transposition_Table> _transpositions;
+		//! hash of the current possible values
+		std::uint64_t _hash = 0;
+
+		//! order of the assumptions (see Search_Options)
+		Branching _branching = Branching::scan;
+		std::uint64_t _seed = 0;
+		//! rank per cell index resp. per value (used to order cells resp. values with the same key)
+		std::vector<std::uint32_t> _cell_ranks;
+		std::vector<std::uint32_t> _value_ranks;
+		//! maximal amount of peers of a cell (degree branching only)
+		std::uint32_t _max_peers = 0;
+		//! base of the restart interval and amount of assumptions at the last restart
+		unsigned long _restart_interval = 0;
+		unsigned long _restart_mark = 0;
+
+		//! amount of solutions after which the search ends (zero counts all, see Search_Options)
+		unsigned long _solution_limit = 1;
+		//! first solution while further solutions are counted
+		std::unique_ptr<Multiple_Value_Sudoku_Grid> _solution;
+
+		//! optional tracer and amount of assumptions whose end was not yet recorded
+		Search_Tracer* _tracer = nullptr;
+		std::uint16_t _traced_depth = 0;
+
+		Solve_Limits _limits;
+		std::chrono::steady_clock::time_point _deadline;
+		Solve_Stats _stats;
+		bool _started = false;
+		bool _finished = false;
+		//! true if at least one cell was non-final after the last propagation
+		bool _not_final = false;
+		Solve_Status _status = Solve_Status::contradiction;
+		std::string _reason;
+
+		//! allocates all buffers
+		void _init(const Search_Options& options);
+
+		//! removes a possible value from a cell
+		//! @return true if the value was possible
+		bool _remove(cell_index_t c, value_t v);
+		//! updates the counters after a value was removed from (delta -1) resp. restored to (delta 1) a cell
+		void _count(cell_index_t c, value_t v, int delta);
+		void _make_final(cell_index_t c);
+		//! marks a value as used in a unit
+		//! @return false if the value was already used (contradiction)
+		bool _use(std::uint32_t unit, value_t v);
+		//! marks a value as used in all units of a cell
+		//! @return false on contradiction (the reason is set)
+		bool _use_in_all_units(cell_index_t c, value_t v);
+		//! reverts all changes made after the undo log had the given size
+		void _undo(std::size_t trail_mark);
+
+		//! step I: analyze and cancel possibilities until nothing changes
+		//! @return false on contradiction or interruption
+		bool _propagate();
+		//! box-line reduction of one box resp. region
+		//! pointing: a value whose cells in the box all lie in one line is cancelled in the rest of that line
+		//! claiming: a value whose cells in a line all lie in the box is cancelled in the rest of the box
+		void _reduce_box(std::uint32_t b, unsigned int& removed_possibilities);
+		//! finalizes the cells whose value is implied by the nogoods
+		//! @return false on contradiction
+		bool _propagate_nogoods(unsigned int& removed_possibilities);
+		//! step II: advances the choice point to its next assumption
+		//! @return false if all assumptions were made
+		bool _next_choice(Choice& c);
+		//! opens a choice point for the current (propagated) grid
+		void _push();
+		//! reverts the assumption of the top choice point which lead to a contradiction
+		//! With nogood learning (or while counting solutions) the cancelled value is finalized for its cell
+		//! and the choice point starts over.
+		//! If that contradicts as well, the choice point is dropped and its parent's assumption fails.
+		//! @param outcome reason why the assumption failed (for the tracer)
+		void _fail_assumption(Trace_Outcome outcome);
+		//! @return key of the assumptions of a cell (constraint branching refines it per value)
+		std::uint32_t _cell_key(cell_index_t c) const;
+		//! sets the ranks of cells and values (random per restart for random branching)
+		void _shuffle();
+		//! @return true if the current restart interval is exhausted
+		bool _restart_due() const;
+		//! drops all choice points except the top level one and starts over
+		void _restart();
+		//! counts the solution of the current grid
+		//! @return true if the search ends (otherwise the solution has to be treated like a contradiction)
+		bool _solution_found();
+		//! ends the search after all choice points were exhausted
+		void _exhausted();
+		//! @return amount of possible assumptions in the current grid
+		std::uint32_t _count_choices() const;
+		//! stores the grid of a choice point whose assumptions all lead to contradictions
+		void _refuted(const Choice& c);
+
+		//! record the begin of the search resp. of an assumption and the end of the innermost recorded one
+		void _trace_search();
+		void _trace_assumption(const Choice& c);
+		void _trace_end(Trace_Outcome outcome, std::size_t changes = 0);
+		//! @return true if the search was stopped due to a timeout or cancellation
+		bool _interrupted();
+		//! ends the search
+		void _finish(Solve_Status status, const std::string& reason);
+		//! @return bytes used by the grid, the undo log and the stack
+		std::size_t _memory() const;
+	};
+
+}
+
+#endif /* Search_h */
@@ -0,0 +1,215 @@
+//
+//  Singles.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Singles.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace sudoku_solver;
+
+namespace {
+
+	inline std::uint64_t bit(value_t v) {return std::uint64_t(1) << (v - 1);}
+	inline value_t lowest_value(std::uint64_t mask) {return value_t(__builtin_ctzll(mask) + 1);}
+	inline bool single(std::uint64_t mask) {return (mask & (mask - 1)) == 0;}
+
+	//! possible values of all cells as bit masks
+	class Singles {
+
+	public:
+		Singles(const Grid_Layout& layout)
+		: _layout(layout), _values(layout.cells(), 0), _candidates(layout.cells()), _used(layout.units(), 0)
+		{
+			const unsigned int n = layout.size();
+			_all = n == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+			std::fill(_candidates.begin(), _candidates.end(), _all);
+			_queue.reserve(layout.cells());
+		}
+
+		//! places a value and cancels it in the peers of the cell (Ib.a)
+		//! @return false on contradiction
+		bool place(cell_index_t c, value_t v) {
+
+			if (!(_candidates[c] & bit(v)))
+				return false;
+
+			_values[c] = v;
+			_candidates[c] = bit(v);
+			++_placed;
+
+			const std::uint32_t* units = _layout.cell_units(c);
+			for (std::uint32_t i = 0; i < _layout.cell_unit_count(c); ++i)
+				_used[units[i]] |= bit(v);
+
+			const cell_index_t* peers = _layout.peers(c);
+			for (std::uint32_t i = 0; i < _layout.peer_count(c); ++i) {
+				const cell_index_t p = peers[i];
+				std::uint64_t& m = _candidates[p];
+				if (_values[p] != 0 || !(m & bit(v)))
+					continue;
+				m &= ~bit(v);
+				if (m == 0)
+					return false;
+				// Ia.a: placed once the queue reaches it
+				if (single(m))
+					_queue.push_back(p);
+			}
+			return true;
+		}
+
+		//! places the naked singles until none is left (Ia.a)
+		//! @return false on contradiction
+		bool naked_singles() {
+			while (!_queue.empty()) {
+				const cell_index_t c = _queue.back();
+				_queue.pop_back();
+				// the value might have been placed as hidden single meanwhile
+				if (_values[c] == 0 && !place(c, lowest_value(_candidates[c])))
+					return false;
+			}
+			return true;
+		}
+
+		//! places the values which are possible in only one cell of a unit (Ia.b)
+		//! @param placed incremented per placed value
+		//! @return false on contradiction
+		bool hidden_singles(unsigned int& placed) {
+
+			const unsigned int n = _layout.size();
+
+			for (std::uint32_t u = 0; u < _layout.units(); ++u) {
+
+				if (_used[u] == _all)
+					continue;
+				const cell_index_t* unit_cells = _layout.unit_cells(u);
+
+				std::uint64_t once = 0;
+				std::uint64_t twice = 0;
+				for (unsigned int k = 0; k < n; ++k) {
+					if (_values[unit_cells[k]] == 0) {
+						const std::uint64_t m = _candidates[unit_cells[k]];
+						twice |= once & m;
+						once |= m;
+					}
+				}
+				// a value without any possible cell
+				if ((once | _used[u]) != _all)
+					return false;
+
+				const std::uint64_t hidden = once & ~twice;
+				if (hidden == 0)
+					continue;
+				for (unsigned int k = 0; k < n; ++k) {
+					const cell_index_t c = unit_cells[k];
+					if (_values[c] != 0)
+						continue;
+					const std::uint64_t h = _candidates[c] & hidden;
+					if (h == 0)
+						continue;
+					// two values which are possible in this cell only
+					if (!single(h) || !place(c, lowest_value(h)))
+						return false;
+					++placed;
+				}
+			}
+			return true;
+		}
+
+		bool solved() const {return _placed == _layout.cells();}
+
+		//! writes the placed values resp. possible values of all cells
+		void write(Multiple_Value_Sudoku_Grid& mg, bool final) const {
+			const unsigned int n = _layout.size();
+			std::vector<value_t> values;
+			for (unsigned int x = 0; x < n; ++x) {
+				for (unsigned int y = 0; y < n; ++y) {
+					values.clear();
+					for (std::uint64_t m = _candidates[x * n + y]; m != 0; m &= m - 1)
+						values.push_back(lowest_value(m));
+					Multiple_Value_Cell& cell = mg.get_cell(x, y);
+					cell = Multiple_Value_Cell(values);
+					if (final)
+						cell.make_final();
+				}
+			}
+		}
+
+	private:
+		const Grid_Layout& _layout;
+		std::uint64_t _all;
+		std::vector<value_t> _values;
+		std::vector<std::uint64_t> _candidates;
+		//! placed values per unit
+		std::vector<std::uint64_t> _used;
+		//! cells with one possible value left which are not placed yet
+		std::vector<cell_index_t> _queue;
+		cell_index_t _placed = 0;
+	};
+
+	//! @return false on contradiction
+	bool propagate(const Single_Value_Sudoku_Grid& sg, Singles& singles, unsigned long& rounds) {
+
+		const unsigned int n = sg.size();
+		for (unsigned int x = 0; x < n; ++x) {
+			for (unsigned int y = 0; y < n; ++y) {
+				const value_t v = sg.get_cell(x, y).get_value();
+				if (v > n || (v != 0 && !singles.place(x * n + y, v)))
+					return false;
+			}
+		}
+
+		while (true) {
+			++rounds;
+			if (!singles.naked_singles())
+				return false;
+			if (singles.solved())
+				return true;
+			unsigned int placed = 0;
+			if (!singles.hidden_singles(placed))
+				return false;
+			if (placed == 0)
+				return true;
+		}
+	}
+
+}
+
+bool sudoku_solver::solve_singles(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout,
+								  Multiple_Value_Sudoku_Grid& mg, Solve_Stats& stats) {
+
+	if (layout.size() > singles_max_size || sg.size() != layout.size()) {
+		mg = create_possibility_grid(sg);
+		return false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	Singles singles {layout};
+	unsigned long rounds = 0;
+	const bool consistent = propagate(sg, singles, rounds);
+
+	const bool solved = consistent && singles.solved();
+	if (consistent) {
+		// all cells are overwritten
+		if (mg.size() != layout.size())
+			mg = Multiple_Value_Sudoku_Grid(layout.size());
+		singles.write(mg, solved);
+	} else {
+		mg = create_possibility_grid(sg);
+	}
+
+	stats.propagation_rounds += rounds;
+	stats.time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	// a grid solved by singles has no other solution
+	if (solved)
+		++stats.solutions;
+	return solved;
+}
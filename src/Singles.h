@@ -0,0 +1,34 @@
+//
+//  Singles.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Singles_h
+#define Singles_h
+
+#include "solve.h"
+#include "Layout.h"
+
+namespace sudoku_solver {
+
+	//! largest grid handled by solve_singles (one bit per value)
+	const unsigned int singles_max_size = 64;
+
+	//! first tier of solve: steps Ia.a (naked singles), Ia.b (hidden singles) and Ib.a (elimination) only
+	//! The possible values are bit masks built from the givens directly; placing a value cancels it in the
+	//! peers of its cell and a cell left with one value is placed right away. The units are scanned for
+	//! hidden singles whenever no naked single is left, until a scan places nothing.
+	//! @param mg receives the solution if the grid was solved, otherwise the start of Search_Engine: the possible
+	//! values left (in the form of create_possibility_grid) resp. those of create_possibility_grid if the grid
+	//! contains a contradiction (so the engine reports it) or is larger than singles_max_size
+	//! @param stats receives the propagation rounds and the time (and the solution if solved)
+	//! @return true if the grid was solved
+	bool solve_singles(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout,
+					   Multiple_Value_Sudoku_Grid& mg, Solve_Stats& stats);
+
+}
+
+#endif /* Singles_h */
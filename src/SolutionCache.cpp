@@ -0,0 +1,53 @@
+//
+//  SolutionCache.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "SolutionCache.h"
+#include "canonical.h"
+
+using namespace sudoku_solver;
+
+const Multiple_Value_Sudoku_Grid* Solution_Cache::find(const Single_Value_Sudoku_Grid& key_grid) {
+	auto it = _index.find(grid_key(key_grid));
+	if (it == _index.end()) {
+		++_misses;
+		return nullptr;
+	}
+	++_hits;
+	// mark as most recently used
+	_entries.splice(_entries.begin(), _entries, it->second);
+	return &it->second->second;
+}
+
+void Solution_Cache::insert(const Single_Value_Sudoku_Grid& key_grid, Multiple_Value_Sudoku_Grid solution) {
+	if (_capacity == 0)
+		return;
+
+	std::string key = grid_key(key_grid);
+	auto it = _index.find(key);
+	if (it != _index.end()) {
+		it->second->second = std::move(solution);
+		_entries.splice(_entries.begin(), _entries, it->second);
+		return;
+	}
+
+	// evict least recently used entry
+	if (_entries.size() >= _capacity) {
+		_index.erase(_entries.back().first);
+		_entries.pop_back();
+	}
+
+	_entries.emplace_front(key, std::move(solution));
+	_index.emplace(std::move(key), _entries.begin());
+}
+
+void Solution_Cache::clear() {
+	_entries.clear();
+	_index.clear();
+	_hits = 0;
+	_misses = 0;
+}
@@ -0,0 +1,54 @@
+//
+//  SolutionCache.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef SolutionCache_h
+#define SolutionCache_h
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include "SudokuGrid.h"
+
+namespace sudoku_solver {
+
+	//! bounded cache of solutions of key grids (see symmetry_key)
+	//! The least recently used entry is evicted when the capacity is exceeded.
+	class Solution_Cache {
+
+	public:
+		Solution_Cache(std::size_t capacity=4096) : _capacity(capacity) { }
+		Solution_Cache(const Solution_Cache&) = delete;
+		Solution_Cache& operator=(const Solution_Cache&) = delete;
+
+		//! looks up the solution of a key grid and counts a hit or a miss
+		//! @return pointer to the solution or nullptr if unknown (only valid until the next insert)
+		const Multiple_Value_Sudoku_Grid* find(const Single_Value_Sudoku_Grid& key_grid);
+		//! stores the solution of a key grid
+		void insert(const Single_Value_Sudoku_Grid& key_grid, Multiple_Value_Sudoku_Grid solution);
+		void clear();
+
+		unsigned long hits() const {return _hits;}
+		unsigned long misses() const {return _misses;}
+		std::size_t size() const {return _entries.size();}
+		std::size_t capacity() const {return _capacity;}
+
+	private:
+
+		using entry_t = std::pair<std::string, Multiple_Value_Sudoku_Grid>;
+
+		std::size_t _capacity;
+		//! most recently used entry first
+		std::list<entry_t> _entries;
+		std::unordered_map<std::string, std::list<entry_t>::iterator> _index;
+		unsigned long _hits = 0;
+		unsigned long _misses = 0;
+	};
+
+}
+
+#endif /* SolutionCache_h */
@@ -7,6 +7,8 @@
 //
 
 #include "SudokuGrid.h"
+
+#include <algorithm>
 #include "util.h"
 
 
@@ -14,7 +16,9 @@ using namespace sudoku_solver;
 
 void sudoku_solver::print_grid(std::ostream& os, const Multiple_Value_Sudoku_Grid& g) {
 	bool first_x = true;
-	int non_final_possibilities = 0;
+	std::size_t non_final_possibilities = 0;
+	// marks the possible values of the current cell (avoids a search per value)
+	std::vector<bool> possible (g.size() + 1);
 	for (int x = 0; x < g.size(); ++x) {
 		if (first_x) first_x = false;
 		else os << std::endl;
@@ -24,15 +28,19 @@ void sudoku_solver::print_grid(std::ostream& os, const Multiple_Value_Sudoku_Gri
 			if(first_y) first_y = false;
 			else os << ' ';
 			
+			const Multiple_Value_Cell& c = g.get_cell(x,y);
+			std::fill(possible.begin(), possible.end(), false);
+			for (value_t v : c.get_values())
+				possible[v] = true;
+			if (!c.is_final())
+				non_final_possibilities += c.possibilities();
+			
 			os << '[';
 			for (value_t v=1; v <= g.size(); ++v) {
-				const Multiple_Value_Cell& c = g.get_cell(x,y);
-				if (has_value(c.get_values(), v))
+				if (possible[v])
 					os << v;
 				else
 					os << ' ';
-				if (!c.is_final())
-					++non_final_possibilities;
 			}
 			os << ']';
 		}
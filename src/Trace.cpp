@@ -0,0 +1,187 @@
+//
+//  Trace.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Trace.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace sudoku_solver;
+
+namespace {
+
+	const char magic[4] = {'S', 'D', 'K', 'T'};
+	const std::uint32_t version = 1;
+
+	std::atomic<std::uint64_t> next_id {1};
+
+	//! buffer used by the calling thread for its last event
+	struct Cached_Buffer {
+		std::uint64_t tracer = 0;
+		void* buffer = nullptr;
+	};
+	thread_local Cached_Buffer cached;
+
+	template <class T>
+	void put(std::ostream& os, T value) {
+		std::uint64_t v = std::uint64_t(value);
+		char bytes[sizeof(T)];
+		for (std::size_t i = 0; i < sizeof(T); ++i)
+			bytes[i] = char((v >> (8 * i)) & 0xff);
+		os.write(bytes, sizeof(T));
+	}
+
+}
+
+const char* sudoku_solver::to_string(Trace_Outcome outcome) {
+	switch (outcome) {
+		case Trace_Outcome::contradiction: return "contradiction";
+		case Trace_Outcome::refuted: return "refuted";
+		case Trace_Outcome::transposition: return "transposition";
+		case Trace_Outcome::solved: return "solved";
+		case Trace_Outcome::restart: return "restart";
+		case Trace_Outcome::interrupted: return "interrupted";
+	}
+	return "unknown";
+}
+
+Search_Tracer::Search_Tracer(std::size_t capacity)
+: _id(next_id++), _capacity(capacity), _start(std::chrono::steady_clock::now())
+{ }
+
+void Search_Tracer::record(Trace_Event event) {
+
+	Thread_Buffer& b = _buffer();
+	if (b.size >= _capacity) {
+		++b.dropped;
+		return;
+	}
+
+	event.time = std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - _start).count());
+
+	// blocks are never moved, so events are written in place
+	if (b.size % block_size == 0)
+		b.blocks.emplace_back(new Trace_Event[block_size]);
+	b.blocks.back()[b.size % block_size] = event;
+	++b.size;
+}
+
+std::size_t Search_Tracer::events() const {
+	std::lock_guard<std::mutex> lock {_mutex};
+	std::size_t events = 0;
+	for (const auto& b : _buffers)
+		events += b->size;
+	return events;
+}
+
+std::size_t Search_Tracer::dropped() const {
+	std::lock_guard<std::mutex> lock {_mutex};
+	std::size_t dropped = 0;
+	for (const auto& b : _buffers)
+		dropped += b->dropped;
+	return dropped;
+}
+
+Search_Tracer::Thread_Buffer& Search_Tracer::_buffer() {
+
+	if (cached.tracer == _id)
+		return *static_cast<Thread_Buffer*>(cached.buffer);
+
+	// first event of this thread (or the thread used another tracer in between)
+	std::lock_guard<std::mutex> lock {_mutex};
+	Thread_Buffer* buffer = nullptr;
+	for (const auto& b : _buffers) {
+		if (b->owner == std::this_thread::get_id())
+			buffer = b.get();
+	}
+	if (!buffer) {
+		_buffers.emplace_back(new Thread_Buffer);
+		buffer = _buffers.back().get();
+		buffer->thread = std::uint32_t(_buffers.size() - 1);
+		buffer->owner = std::this_thread::get_id();
+	}
+	cached.tracer = _id;
+	cached.buffer = buffer;
+	return *buffer;
+}
+
+void Search_Tracer::write_json(std::ostream& os) const {
+
+	std::lock_guard<std::mutex> lock {_mutex};
+	os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	bool first = true;
+	for (const auto& b : _buffers) {
+
+		// the size of the current grid is needed for the coordinates of the cells
+		unsigned int size = 1;
+
+		for (std::size_t i = 0; i < b->size; ++i) {
+			const Trace_Event& e = (*b)[i];
+			os << (first ? "\n" : ",\n");
+			first = false;
+
+			os << "{\"pid\":1,\"tid\":" << b->thread << ",\"ts\":" << e.time / 1000 << '.'
+			   << char('0' + e.time / 100 % 10) << char('0' + e.time / 10 % 10) << char('0' + e.time % 10);
+			switch (e.kind) {
+				case Trace_Event::search_begin:
+					size = e.value != 0 ? e.value : 1;
+					os << ",\"ph\":\"B\",\"name\":\"search " << size << "x" << size << "\"";
+					break;
+				case Trace_Event::search_end:
+					os << ",\"ph\":\"E\"";
+					break;
+				case Trace_Event::assumption_begin:
+					os << ",\"ph\":\"B\",\"name\":\"cell (" << e.cell / size + 1 << ", " << e.cell % size + 1
+					   << ") not " << e.value << "\"";
+					break;
+				case Trace_Event::assumption_end:
+					os << ",\"ph\":\"E\"";
+					break;
+			}
+			os << ",\"args\":{\"depth\":" << e.depth << ",\"assumptions\":" << e.assumptions
+			   << ",\"propagation rounds\":" << e.propagation_rounds;
+			if (e.kind == Trace_Event::assumption_end || e.kind == Trace_Event::search_end)
+				os << ",\"outcome\":\"" << to_string(e.outcome) << "\"";
+			if (e.kind == Trace_Event::assumption_end)
+				os << ",\"changes\":" << e.changes;
+			os << "}}";
+		}
+	}
+	os << "\n]}" << std::endl;
+}
+
+void Search_Tracer::write_binary(std::ostream& os) const {
+
+	std::lock_guard<std::mutex> lock {_mutex};
+	std::uint64_t count = 0;
+	for (const auto& b : _buffers)
+		count += b->size;
+
+	os.write(magic, sizeof(magic));
+	put<std::uint32_t>(os, version);
+	put<std::uint64_t>(os, count);
+
+	for (const auto& b : _buffers) {
+		for (std::size_t i = 0; i < b->size; ++i) {
+			const Trace_Event& e = (*b)[i];
+			put<std::uint32_t>(os, b->thread);
+			put<std::uint8_t>(os, e.kind);
+			put<std::uint8_t>(os, std::uint8_t(e.outcome));
+			put<std::uint16_t>(os, e.depth);
+			put<std::uint32_t>(os, e.cell);
+			put<std::uint16_t>(os, e.value);
+			put<std::uint64_t>(os, e.time);
+			put<std::uint64_t>(os, e.assumptions);
+			put<std::uint64_t>(os, e.propagation_rounds);
+			put<std::uint32_t>(os, e.changes);
+		}
+	}
+}
@@ -0,0 +1,118 @@
+//
+//  Trace.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Trace_h
+#define Trace_h
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sudoku_solver {
+
+	//! how an assumption resp. a search ended
+	enum class Trace_Outcome : std::uint8_t {
+		//! step I found a contradiction right after the assumption
+		contradiction,
+		//! all assumptions made below it lead to contradictions
+		refuted,
+		//! the grid was refuted before (see Search_Options::transposition_memory)
+		transposition,
+		solved,
+		//! the search started over (see Search_Options::restart_interval)
+		restart,
+		//! timeout, cancellation or a limit
+		interrupted
+	};
+
+	//! @return short description of the outcome
+	const char* to_string(Trace_Outcome outcome);
+
+	//! event of the search recorded by Search_Tracer
+	struct Trace_Event {
+		enum Kind : std::uint8_t {search_begin, search_end, assumption_begin, assumption_end};
+
+		//! nanoseconds since the tracer was created
+		std::uint64_t time = 0;
+		//! total amount of assumptions resp. propagation rounds of the search so far
+		std::uint64_t assumptions = 0;
+		std::uint64_t propagation_rounds = 0;
+		//! assumption: cell index and removed value (search_begin: size of the grid in value)
+		std::uint32_t cell = 0;
+		std::uint16_t value = 0;
+		//! amount of active assumptions (including this one)
+		std::uint16_t depth = 0;
+		//! assumption_end: amount of changes made by step I after the assumption
+		std::uint32_t changes = 0;
+		Kind kind = search_begin;
+		Trace_Outcome outcome = Trace_Outcome::solved;
+	};
+
+	//! records the assumptions of searches (see Search_Options::tracer)
+	//! Each thread appends to its own buffer of fixed-size blocks without any locking (only its first event
+	//! registers the buffer). The events are written after all searches have ended, either as Chrome
+	//! trace-event JSON (chrome://tracing, Perfetto) or as compact binary log.
+	class Search_Tracer {
+
+	public:
+		//! @param capacity maximal amount of events per thread (further events are dropped)
+		explicit Search_Tracer(std::size_t capacity = std::size_t(1) << 24);
+		Search_Tracer(const Search_Tracer&) = delete;
+		Search_Tracer& operator=(const Search_Tracer&) = delete;
+
+		//! records an event of the calling thread (the time is set by the tracer)
+		void record(Trace_Event event);
+
+		//! @return amount of recorded resp. dropped events of all threads
+		std::size_t events() const;
+		std::size_t dropped() const;
+
+		//! writes the events as Chrome trace-event JSON (one track per thread, assumptions as nested spans)
+		void write_json(std::ostream& os) const;
+		//! writes the events as binary log
+		//!   header (16 bytes): 'SDKT', version (uint32), amount of events (uint64)
+		//!   per event (42 bytes): thread (uint32), kind (uint8), outcome (uint8), depth (uint16), cell (uint32),
+		//!   value (uint16), time in ns (uint64), assumptions (uint64), propagation rounds (uint64), changes (uint32)
+		//! All integers are little endian.
+		void write_binary(std::ostream& os) const;
+
+	private:
+		static const std::size_t block_size = 4096;
+
+		//! events of one thread (written by this thread only)
+		struct Thread_Buffer {
+			std::thread::id owner;
+			//! index of the thread (in the order of their first events)
+			std::uint32_t thread;
+			std::vector<std::unique_ptr<Trace_Event[]>> blocks;
+			std::size_t size = 0;
+			std::size_t dropped = 0;
+
+			const Trace_Event& operator[](std::size_t i) const {return blocks[i / block_size][i % block_size];}
+		};
+
+		//! distinguishes tracers in the per-thread lookup (addresses may be reused)
+		const std::uint64_t _id;
+		const std::size_t _capacity;
+		const std::chrono::steady_clock::time_point _start;
+
+		//! guards the registration of buffers
+		mutable std::mutex _mutex;
+		std::vector<std::unique_ptr<Thread_Buffer>> _buffers;
+
+		//! @return the buffer of the calling thread
+		Thread_Buffer& _buffer();
+	};
+
+}
+
+#endif /* Trace_h */
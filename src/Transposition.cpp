@@ -0,0 +1,63 @@
+//
+//  Transposition.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Transposition.h"
+
+#include <random>
+
+using namespace sudoku_solver;
+
+Zobrist_Keys::Zobrist_Keys(unsigned int size)
+: _size(size), _keys(std::size_t(size) * size * size)
+{
+	// fixed seed: hashes are reproducible between runs
+	std::mt19937_64 random {0x5d0c0b1a};
+	for (std::uint64_t& k : _keys)
+		k = random();
+}
+
+Transposition_Table::Transposition_Table(std::size_t memory) {
+	std::size_t buckets = 1;
+	while (buckets * 2 * sizeof(Bucket) <= memory)
+		buckets *= 2;
+	_buckets.resize(buckets);
+}
+
+bool Transposition_Table::contains(std::uint64_t hash) const {
+	if (hash == 0)
+		return false;
+	for (const Entry& e : _bucket(hash).entries) {
+		if (e.hash == hash)
+			return true;
+	}
+	return false;
+}
+
+void Transposition_Table::insert(std::uint64_t hash, std::uint32_t work) {
+	if (hash == 0)
+		return;
+
+	Bucket& bucket = _buckets[hash & (_buckets.size() - 1)];
+
+	// prefer the same hash, then an empty entry, then the cheapest refutation
+	Entry* target = &bucket.entries[0];
+	for (Entry& e : bucket.entries) {
+		if (e.hash == hash) {
+			if (work > e.work)
+				e.work = work;
+			return;
+		}
+		if (target->hash != 0 && (e.hash == 0 || e.work < target->work))
+			target = &e;
+	}
+
+	if (target->hash == 0)
+		++_count;
+	target->hash = hash;
+	target->work = work;
+}
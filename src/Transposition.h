@@ -0,0 +1,74 @@
+//
+//  Transposition.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Transposition_h
+#define Transposition_h
+
+#include <cstdint>
+#include <vector>
+
+namespace sudoku_solver {
+
+	//! Zobrist hashing of the possible values of a grid
+	//! Each possibility (cell, value) has a random key. The hash of a grid is the xor of the keys of all
+	//! cancelled possibilities, hence it is updated in constant time whenever a value is removed or restored.
+	class Zobrist_Keys {
+
+	public:
+		//! @param size size of the grid (keys for size^3 possibilities)
+		explicit Zobrist_Keys(unsigned int size);
+
+		//! @return key of the value (1 to size) of the cell (cell index)
+		std::uint64_t key(std::uint32_t cell, unsigned int value) const {return _keys[cell * _size + value - 1];}
+
+	private:
+		unsigned int _size;
+		std::vector<std::uint64_t> _keys;
+	};
+
+	//! fixed size table of hashes of grids which are known to contain a contradiction
+	//! The table consists of buckets of four entries. If a bucket is full, the entry which was the least work
+	//! to refute (in assumptions) is replaced.
+	class Transposition_Table {
+
+	public:
+		//! @param memory maximal amount of bytes used by the table (at least one bucket, rounded down to a power of two)
+		explicit Transposition_Table(std::size_t memory);
+
+		//! @return true if the grid with the given hash is known to contain a contradiction
+		bool contains(std::uint64_t hash) const;
+		//! stores the hash of a grid containing a contradiction
+		//! @param work amount of assumptions made to refute the grid
+		void insert(std::uint64_t hash, std::uint32_t work);
+
+		//! @return amount of stored hashes
+		std::size_t size() const {return _count;}
+		//! @return maximal amount of stored hashes
+		std::size_t capacity() const {return _buckets.size() * bucket_size;}
+
+	private:
+		static const unsigned int bucket_size = 4;
+
+		//! (a hash of zero marks an empty entry)
+		struct Entry {
+			std::uint64_t hash = 0;
+			std::uint32_t work = 0;
+		};
+		struct Bucket {
+			Entry entries[bucket_size];
+		};
+
+		std::vector<Bucket> _buckets;
+		std::size_t _count = 0;
+
+		const Bucket& _bucket(std::uint64_t hash) const {return _buckets[hash & (_buckets.size() - 1)];}
+	};
+
+}
+
+#endif /* Transposition_h */
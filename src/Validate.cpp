@@ -0,0 +1,143 @@
+//
+//  Validate.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "Validate.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! amount of grids checked at once
+	const unsigned int lanes = 16;
+
+	//! one bit per value (bit 0 for empty cells, bit 15 for values out of range), one lane per grid
+	typedef std::uint16_t lanes_t __attribute__((vector_size(2 * lanes)));
+
+}
+
+Validation_Result sudoku_solver::validate(const Single_Value_Sudoku_Grid& sg) {
+	return validate(sg, Grid_Layout::standard(sg.size()));
+}
+
+Validation_Result sudoku_solver::validate(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout) {
+	const unsigned int n = layout.size();
+	std::vector<std::uint8_t> cells (layout.cells());
+	for (unsigned int x = 0; x < n; ++x) {
+		for (unsigned int y = 0; y < n; ++y) {
+			// (values beyond 255 are out of range for any supported size)
+			value_t v = sg.get_cell(x, y).get_value();
+			cells[x * n + y] = std::uint8_t(v > 255 ? 255 : v);
+		}
+	}
+	return validate(cells.data(), layout);
+}
+
+Validation_Result sudoku_solver::validate(const std::uint8_t* cells, const Grid_Layout& layout) {
+
+	const unsigned int n = layout.size();
+	Validation_Result result;
+
+	for (cell_index_t c = 0; c < layout.cells(); ++c) {
+		if (cells[c] == 0)
+			result.complete = false;
+	}
+
+	// one bit per value (sizes up to 255)
+	std::uint64_t used[4];
+
+	for (std::uint32_t u = 0; u < layout.units(); ++u) {
+
+		std::fill(used, used + 4, 0);
+		const cell_index_t* unit_cells = layout.unit_cells(u);
+
+		for (unsigned int k = 0; k < n; ++k) {
+			value_t v = cells[unit_cells[k]];
+			if (v == 0)
+				continue;
+
+			std::uint64_t bit = std::uint64_t(1) << (v % 64);
+			if (v > n || (used[v / 64] & bit)) {
+				result.valid = false;
+				result.unit = u;
+				result.cell = unit_cells[k];
+				result.value = v;
+				return result;
+			}
+			used[v / 64] |= bit;
+		}
+	}
+	return result;
+}
+
+// (compiled for AVX2 as well, the variant is chosen when the program is loaded)
+__attribute__((target_clones("avx2", "default")))
+void sudoku_solver::validate_9x9(const std::uint8_t* cells, std::size_t count, Validation_Result* results) {
+
+	const unsigned int n = 9;
+	const Grid_Layout& layout = Grid_Layout::standard(n);
+
+	// bit of each byte: bit 0 for empty cells, bits 1 to 9 for the values and bit 15 for values out of range
+	std::uint16_t bits[256];
+	for (unsigned int v = 0; v < 256; ++v)
+		bits[v] = std::uint16_t(v <= n ? 1 << v : 1 << 15);
+
+	for (std::size_t begin = 0; begin < count; begin += lanes) {
+
+		const std::size_t block = std::min<std::size_t>(lanes, count - begin);
+		const std::uint8_t* grids = cells + begin * n * n;
+
+		// bit per cell via a table (there is no variable shift of 16 bit lanes), unused lanes are empty grids
+		alignas(sizeof(lanes_t)) std::uint16_t cell_bits[n * n][lanes];
+		for (unsigned int l = 0; l < block; ++l) {
+			const std::uint8_t* grid = grids + l * n * n;
+			for (unsigned int c = 0; c < n * n; ++c)
+				cell_bits[c][l] = bits[grid[c]];
+		}
+		for (unsigned int l = unsigned(block); l < lanes; ++l) {
+			for (unsigned int c = 0; c < n * n; ++c)
+				cell_bits[c][l] = 1;
+		}
+
+		// a bit occurring twice in a unit is a conflict
+		// (rows, columns and boxes are accumulated at once while going through the cells in order)
+		lanes_t all = {};
+		lanes_t twice = {};
+		lanes_t columns[n] = {};
+		lanes_t boxes[3] = {};
+		for (unsigned int x = 0; x < n; ++x) {
+			if (x % 3 == 0)
+				boxes[0] = boxes[1] = boxes[2] = (lanes_t) {};
+			lanes_t line = {};
+			for (unsigned int y = 0; y < n; ++y) {
+				lanes_t b = *reinterpret_cast<const lanes_t*>(cell_bits[x * n + y]);
+				twice |= (line & b) | (columns[y] & b) | (boxes[y / 3] & b);
+				line |= b;
+				columns[y] |= b;
+				boxes[y / 3] |= b;
+			}
+			all |= line;
+		}
+
+		// values out of range (empty cells are no conflict)
+		twice |= all & ((lanes_t) {} + (1 << 15));
+		twice &= ~((lanes_t) {} + 1);
+
+		for (unsigned int l = 0; l < block; ++l) {
+			Validation_Result& result = results[begin + l];
+			if (twice[l] != 0) {
+				result = validate(grids + l * n * n, layout);
+			} else {
+				result = Validation_Result();
+				result.complete = (all[l] & 1) == 0;
+			}
+		}
+	}
+}
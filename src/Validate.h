@@ -0,0 +1,47 @@
+//
+//  Validate.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef Validate_h
+#define Validate_h
+
+#include <cstdint>
+#include "SudokuGrid.h"
+#include "Layout.h"
+
+namespace sudoku_solver {
+
+	//! result of checking the values of a (partially) filled grid against its units
+	struct Validation_Result {
+		//! false if a value appears twice in a unit or is out of range
+		bool valid = true;
+		//! true if all cells have a value
+		bool complete = true;
+		//! first conflict (units in layout order, cells in unit order): the unit and the cell in which
+		//! the value appears for the second time (resp. the cell with a value out of range)
+		std::uint32_t unit = 0;
+		cell_index_t cell = 0;
+		value_t value = 0;
+
+		bool solved() const {return valid && complete;}
+	};
+
+	//! checks each unit of a grid via bit masks of the values
+	Validation_Result validate(const Single_Value_Sudoku_Grid& sg);
+	//! @param layout units of the grid (of the same size)
+	Validation_Result validate(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout);
+	//! @param cells value per cell index (zero for empty cells)
+	Validation_Result validate(const std::uint8_t* cells, const Grid_Layout& layout);
+
+	//! checks many standard 9x9 grids (81 values per grid, see above)
+	//! Blocks of grids are checked at once with one SIMD lane per grid; only grids with a conflict are
+	//! checked again one by one to find the first conflict.
+	void validate_9x9(const std::uint8_t* cells, std::size_t count, Validation_Result* results);
+
+}
+
+#endif /* Validate_h */
@@ -0,0 +1,238 @@
+//
+//  canonical.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "canonical.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! signature of a line, band or stack (invariant under all transformations except transposition)
+	using signature_t = std::vector<unsigned int>;
+
+	//! Orders lines by their signatures. Blocks of box_size lines (bands resp. stacks) are ordered by the
+	//! combined signature of their lines and the lines inside of each block by their own signature.
+	//! @return the original line index per new line index
+	std::vector<unsigned int> order_lines(const std::vector<signature_t>& signatures, unsigned int box_size) {
+
+		std::vector<std::vector<unsigned int>> blocks (box_size);
+		std::vector<signature_t> block_signatures (box_size);
+
+		auto by_signature = [&signatures](unsigned int a, unsigned int b) {return signatures[a] > signatures[b];};
+
+		for (unsigned int k = 0; k < box_size; ++k) {
+			for (unsigned int i = 0; i < box_size; ++i)
+				blocks[k].push_back(k * box_size + i);
+			std::stable_sort(blocks[k].begin(), blocks[k].end(), by_signature);
+
+			// the sorted signatures of the lines form the signature of the block
+			for (unsigned int l : blocks[k])
+				block_signatures[k].insert(block_signatures[k].end(), signatures[l].begin(), signatures[l].end());
+		}
+
+		std::vector<unsigned int> block_order (box_size);
+		for (unsigned int k = 0; k < box_size; ++k)
+			block_order[k] = k;
+		std::stable_sort(block_order.begin(), block_order.end(),
+						 [&block_signatures](unsigned int a, unsigned int b) {return block_signatures[a] > block_signatures[b];});
+
+		std::vector<unsigned int> order;
+		for (unsigned int k : block_order)
+			order.insert(order.end(), blocks[k].begin(), blocks[k].end());
+		return order;
+	}
+
+	//! @return rank of each signature (equal signatures share a rank) as single valued signatures
+	std::vector<signature_t> ranks(const std::vector<signature_t>& signatures) {
+		std::vector<signature_t> sorted = signatures;
+		std::sort(sorted.begin(), sorted.end());
+		sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+		std::vector<signature_t> tmp;
+		for (auto& s : signatures)
+			tmp.push_back({(unsigned int) (std::lower_bound(sorted.begin(), sorted.end(), s) - sorted.begin())});
+		return tmp;
+	}
+
+	//! candidate for the key grid of one orientation
+	struct Candidate {
+		Grid_Transform transform;
+		std::vector<value_t> cells;
+	};
+
+	Candidate key_candidate(const Single_Value_Sudoku_Grid& sg, bool transposed) {
+
+		const unsigned int n = sg.size();
+		auto value = [&sg, transposed](unsigned int x, unsigned int y) {
+			return transposed ? sg.get_cell(y, x).get_value() : sg.get_cell(x, y).get_value();
+		};
+
+		// how often each value is given (invariant under relabeling)
+		std::vector<unsigned int> frequency (n + 1, 0);
+		for (unsigned int x = 0; x < n; ++x) {
+			for (unsigned int y = 0; y < n; ++y)
+				++frequency[value(x, y)];
+		}
+
+		// Lines are colored by refinement: Starting with equal colors for all lines, the new color of a line
+		// is the rank of its old color combined with the (sorted) colors of the crossing lines at its givens
+		// and the frequencies of their values.
+		std::vector<signature_t> row_signatures (n, signature_t(1, 0));
+		std::vector<signature_t> column_signatures (n, signature_t(1, 0));
+		for (int round = 0; round < 3; ++round) {
+
+			std::vector<signature_t> rows (n);
+			std::vector<signature_t> columns (n);
+			std::vector<std::vector<std::pair<unsigned int, unsigned int>>> row_givens (n);
+			std::vector<std::vector<std::pair<unsigned int, unsigned int>>> column_givens (n);
+			for (unsigned int x = 0; x < n; ++x) {
+				for (unsigned int y = 0; y < n; ++y) {
+					value_t v = value(x, y);
+					if (v != 0) {
+						row_givens[x].push_back({column_signatures[y][0], frequency[v]});
+						column_givens[y].push_back({row_signatures[x][0], frequency[v]});
+					}
+				}
+			}
+			for (unsigned int i = 0; i < n; ++i) {
+				std::sort(row_givens[i].begin(), row_givens[i].end(), std::greater<std::pair<unsigned int, unsigned int>>());
+				std::sort(column_givens[i].begin(), column_givens[i].end(), std::greater<std::pair<unsigned int, unsigned int>>());
+				rows[i] = {row_signatures[i][0], (unsigned int) row_givens[i].size()};
+				columns[i] = {column_signatures[i][0], (unsigned int) column_givens[i].size()};
+				for (auto& g : row_givens[i]) {
+					rows[i].push_back(g.first);
+					rows[i].push_back(g.second);
+				}
+				for (auto& g : column_givens[i]) {
+					columns[i].push_back(g.first);
+					columns[i].push_back(g.second);
+				}
+			}
+
+			// replace signatures by their ranks
+			row_signatures = ranks(rows);
+			column_signatures = ranks(columns);
+		}
+
+		Candidate c;
+		c.transform.transposed = transposed;
+		c.transform.rows = order_lines(row_signatures, sg.box_size());
+		c.transform.columns = order_lines(column_signatures, sg.box_size());
+		c.transform.values.assign(n + 1, 0);
+
+		// relabel values in order of their first appearance
+		value_t next = 1;
+		c.cells.reserve(n * n);
+		for (unsigned int x = 0; x < n; ++x) {
+			for (unsigned int y = 0; y < n; ++y) {
+				value_t v = value(c.transform.rows[x], c.transform.columns[y]);
+				if (v != 0 && c.transform.values[v] == 0)
+					c.transform.values[v] = next++;
+				c.cells.push_back(v == 0 ? 0 : c.transform.values[v]);
+			}
+		}
+		// values without any appearance are interchangeable
+		for (value_t v = 1; v <= n; ++v) {
+			if (c.transform.values[v] == 0)
+				c.transform.values[v] = next++;
+		}
+
+		return c;
+	}
+
+	//! @return the original value per new value (index 0 is unused)
+	std::vector<value_t> inverse_values(const Grid_Transform& t) {
+		std::vector<value_t> inverse (t.values.size(), 0);
+		for (value_t v = 1; v < t.values.size(); ++v)
+			inverse[t.values[v]] = v;
+		return inverse;
+	}
+
+	//! @return coordinates of the cell in the original grid which is mapped to (x, y)
+	std::pair<unsigned int, unsigned int> source_coord(const Grid_Transform& t, unsigned int x, unsigned int y) {
+		if (t.transposed)
+			return {t.columns[y], t.rows[x]};
+		return {t.rows[x], t.columns[y]};
+	}
+}
+
+Symmetry_Key sudoku_solver::symmetry_key(const Single_Value_Sudoku_Grid& sg) {
+
+	Candidate plain = key_candidate(sg, false);
+	Candidate transposed = key_candidate(sg, true);
+
+	// choose the lexicographically smaller orientation
+	Candidate& best = (transposed.cells < plain.cells) ? transposed : plain;
+
+	Symmetry_Key key {Single_Value_Sudoku_Grid(sg.size()), std::move(best.transform)};
+	for (unsigned int x = 0; x < sg.size(); ++x) {
+		for (unsigned int y = 0; y < sg.size(); ++y)
+			key.grid.get_cell(x, y).set_value(best.cells[x * sg.size() + y]);
+	}
+	return key;
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::apply(const Grid_Transform& t, const Single_Value_Sudoku_Grid& sg) {
+	Single_Value_Sudoku_Grid tmp {sg.size()};
+	for (unsigned int x = 0; x < sg.size(); ++x) {
+		for (unsigned int y = 0; y < sg.size(); ++y) {
+			auto src = source_coord(t, x, y);
+			value_t v = sg.get_cell(src.first, src.second).get_value();
+			tmp.get_cell(x, y).set_value(t.values[v]);
+		}
+	}
+	return tmp;
+}
+
+Single_Value_Sudoku_Grid sudoku_solver::apply_inverse(const Grid_Transform& t, const Single_Value_Sudoku_Grid& sg) {
+	std::vector<value_t> inverse = inverse_values(t);
+	Single_Value_Sudoku_Grid tmp {sg.size()};
+	for (unsigned int x = 0; x < sg.size(); ++x) {
+		for (unsigned int y = 0; y < sg.size(); ++y) {
+			auto src = source_coord(t, x, y);
+			tmp.get_cell(src.first, src.second).set_value(inverse[sg.get_cell(x, y).get_value()]);
+		}
+	}
+	return tmp;
+}
+
+Multiple_Value_Sudoku_Grid sudoku_solver::apply_inverse(const Grid_Transform& t, const Multiple_Value_Sudoku_Grid& mg) {
+	std::vector<value_t> inverse = inverse_values(t);
+	Multiple_Value_Sudoku_Grid tmp {mg.size()};
+	for (unsigned int x = 0; x < mg.size(); ++x) {
+		for (unsigned int y = 0; y < mg.size(); ++y) {
+			const Multiple_Value_Cell& c = mg.get_cell(x, y);
+			auto src = source_coord(t, x, y);
+			Multiple_Value_Cell& target = tmp.get_cell(src.first, src.second);
+			for (value_t v : c.get_values())
+				target.add_value(inverse[v]);
+			if (c.is_final())
+				target.make_final();
+		}
+	}
+	return tmp;
+}
+
+std::string sudoku_solver::grid_key(const Single_Value_Sudoku_Grid& sg) {
+	std::string key;
+	key.reserve(sg.size() * sg.size() * 2 + 2);
+	key.push_back(char(sg.size() & 0xff));
+	key.push_back(char(sg.size() >> 8));
+	for (unsigned int x = 0; x < sg.size(); ++x) {
+		for (unsigned int y = 0; y < sg.size(); ++y) {
+			value_t v = sg.get_cell(x, y).get_value();
+			key.push_back(char(v & 0xff));
+			if (sg.size() > 0xff)
+				key.push_back(char(v >> 8));
+		}
+	}
+	return key;
+}
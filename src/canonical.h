@@ -0,0 +1,58 @@
+//
+//  canonical.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#ifndef canonical_h
+#define canonical_h
+
+#include <string>
+#include <vector>
+#include "SudokuGrid.h"
+
+namespace sudoku_solver {
+
+	//! validity preserving transformation of a sudoku grid
+	//! (transposition followed by a permutation of rows and columns and a relabeling of values)
+	//! A cell (x, y) of the transformed grid holds the relabeled value of the cell (rows[x], columns[y])
+	//! of the (possibly transposed) original grid.
+	struct Grid_Transform {
+		bool transposed = false;
+		//! row of the (transposed) original grid per row of the transformed grid
+		std::vector<unsigned int> rows;
+		//! column of the (transposed) original grid per column of the transformed grid
+		std::vector<unsigned int> columns;
+		//! new value per original value (index 0 is unused)
+		std::vector<value_t> values;
+	};
+
+	//! key grid of the symmetry class of a grid and the transformation which leads to it
+	struct Symmetry_Key {
+		Single_Value_Sudoku_Grid grid;
+		Grid_Transform transform;
+	};
+
+	//! Transforms the grid into a key grid of its symmetry class.
+	//! Digit relabeling, band and stack swaps, row and column swaps inside of them and transposition
+	//! are taken into account. Rows, columns, bands and stacks are ordered by invariant signatures
+	//! (refined from the givens and how they are spread over the crossing lines), ties keep their original order.
+	//! Hence this is no canonical form: two grids of the same class may get different key grids if lines tie,
+	//! which happens mostly for grids with few givens or symmetric givens (equal key grids always mean
+	//! equivalent grids). The transformation is always exact and can be reverted via apply_inverse.
+	Symmetry_Key symmetry_key(const Single_Value_Sudoku_Grid& sg);
+
+	//! @return the transformed grid
+	Single_Value_Sudoku_Grid apply(const Grid_Transform& t, const Single_Value_Sudoku_Grid& sg);
+	//! @return the grid which is mapped to the given one by the transformation
+	Single_Value_Sudoku_Grid apply_inverse(const Grid_Transform& t, const Single_Value_Sudoku_Grid& sg);
+	//! @return the grid which is mapped to the given one by the transformation (final marks are kept)
+	Multiple_Value_Sudoku_Grid apply_inverse(const Grid_Transform& t, const Multiple_Value_Sudoku_Grid& mg);
+
+	//! @return compact string identifying the grid (size and all values)
+	std::string grid_key(const Single_Value_Sudoku_Grid& sg);
+}
+
+#endif /* canonical_h */
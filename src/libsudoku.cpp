@@ -0,0 +1,182 @@
+//
+//  libsudoku.cpp
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+
+#include "libsudoku.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "solve.h"
+#include "Lockstep.h"
+
+using namespace sudoku_solver;
+
+namespace {
+
+	//! amount of grids a thread of solve_batch takes at once
+	const std::size_t chunk = 256;
+	//! capacity of the solution cache of each thread of solve_batch
+	const std::size_t cache_size = 4096;
+
+	//! @return true if grids of this dimension can be passed as bytes
+	bool valid_dimension(std::size_t dim) {
+		std::size_t box_size = std::size_t(sqrt(double(dim)));
+		return dim != 0 && dim <= 255 && box_size * box_size == dim;
+	}
+
+	//! reads a grid from its cells
+	//! @return false if a value is out of range
+	bool read_cells(const std::uint8_t* cells, unsigned int dim, Single_Value_Sudoku_Grid& sg) {
+		for (unsigned int x = 0; x < dim; ++x) {
+			for (unsigned int y = 0; y < dim; ++y) {
+				value_t v = cells[x * dim + y];
+				if (v > dim)
+					return false;
+				sg.get_cell(x, y).set_value(v);
+			}
+		}
+		return true;
+	}
+
+	//! writes the final values of a grid to its cells (other cells are zero)
+	void write_cells(const Multiple_Value_Sudoku_Grid& mg, std::uint8_t* cells) {
+		const unsigned int dim = mg.size();
+		for (unsigned int x = 0; x < dim; ++x) {
+			for (unsigned int y = 0; y < dim; ++y) {
+				const Multiple_Value_Cell& cell = mg.get_cell(x, y);
+				cells[x * dim + y] = std::uint8_t(cell.is_final() && cell.possibilities() == 1 ? cell.get_values()[0] : 0);
+			}
+		}
+	}
+
+}
+
+unsigned int sudoku_abi_version(void) {
+	return SUDOKU_ABI_VERSION;
+}
+
+status_t solve_puzzle(const uint8_t* cells, size_t dim, uint8_t* out) {
+
+	if (!cells || !out || !valid_dimension(dim))
+		return SUDOKU_INVALID;
+
+	// no exception may leave the C interface
+	try {
+		Single_Value_Sudoku_Grid sg {(unsigned int) dim};
+		if (!read_cells(cells, (unsigned int) dim, sg))
+			return SUDOKU_INVALID;
+
+		Solve_Result result = solve(sg, Grid_Layout::standard((unsigned int) dim));
+		write_cells(result.grid, out);
+		return status_t(result.status);
+	} catch (...) {
+		return SUDOKU_INVALID;
+	}
+}
+
+size_t solve_batch(const uint8_t* cells, size_t n_puzzles, size_t dim, uint8_t* out, status_t* status,
+				   unsigned int threads) {
+
+	if (!cells || !out || !status || !valid_dimension(dim)) {
+		if (status)
+			std::fill(status, status + n_puzzles, status_t(SUDOKU_INVALID));
+		return 0;
+	}
+
+	const unsigned int n = (unsigned int) dim;
+	const std::size_t grid_bytes = dim * dim;
+	if (threads == 0)
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	// further threads would find no chunk left
+	threads = (unsigned int) std::max<std::size_t>(std::min<std::size_t>(threads, (n_puzzles + chunk - 1) / chunk), 1);
+
+	std::atomic<std::size_t> next {0};
+	std::atomic<std::size_t> solved {0};
+
+	auto work = [&]() {
+		try {
+			// one cache per thread (the cache is not synchronized)
+			Solution_Cache cache {cache_size};
+			std::vector<Single_Value_Sudoku_Grid> grids;
+			std::vector<std::size_t> indices;
+			Single_Value_Sudoku_Grid sg {n};
+			std::size_t solved_here = 0;
+
+			for (std::size_t begin; (begin = next.fetch_add(chunk)) < n_puzzles; ) {
+				const std::size_t end = std::min(begin + chunk, n_puzzles);
+				std::fill(status + begin, status + end, status_t(SUDOKU_INVALID));
+
+				// blocks of valid grids are solved at once
+				for (std::size_t i = begin; i < end; ) {
+					grids.clear();
+					indices.clear();
+					for (; i < end && grids.size() < lockstep_lanes; ++i) {
+						if (!read_cells(cells + i * grid_bytes, n, sg))
+							continue;
+						grids.push_back(sg);
+						indices.push_back(i);
+					}
+
+					std::vector<Solve_Result> results = solve_lockstep(grids, Solve_Limits(), Search_Options(), &cache);
+					for (std::size_t k = 0; k < results.size(); ++k) {
+						write_cells(results[k].grid, out + indices[k] * grid_bytes);
+						status[indices[k]] = status_t(results[k].status);
+						if (results[k].status == Solve_Status::solved)
+							++solved_here;
+					}
+				}
+			}
+			solved += solved_here;
+		} catch (...) {
+			// the unsolved grids of this thread keep the status SUDOKU_INVALID
+		}
+	};
+
+	// if a thread cannot be started the threads started so far take over its chunks
+	std::vector<std::thread> pool;
+	try {
+		pool.reserve(threads - 1);
+		for (unsigned int t = 1; t < threads; ++t)
+			pool.emplace_back(work);
+	} catch (...) { }
+	work();
+	for (std::thread& t : pool)
+		t.join();
+
+	return solved;
+}
+
+status_t count_solutions(const uint8_t* cells, size_t dim, uint64_t limit, uint64_t time_limit_ms, uint64_t* count,
+						 uint8_t* out) {
+
+	if (!cells || !count || !valid_dimension(dim))
+		return SUDOKU_INVALID;
+	*count = 0;
+
+	try {
+		Single_Value_Sudoku_Grid sg {(unsigned int) dim};
+		if (!read_cells(cells, (unsigned int) dim, sg))
+			return SUDOKU_INVALID;
+
+		Search_Options options;
+		options.solution_limit = limit;
+		Solve_Limits limits;
+		limits.time = std::chrono::milliseconds(time_limit_ms);
+		Solve_Result result = solve(sg, Grid_Layout::standard((unsigned int) dim), limits, options);
+		*count = result.stats.solutions;
+		if (out)
+			write_cells(result.grid, out);
+		return status_t(result.status);
+	} catch (...) {
+		return SUDOKU_INVALID;
+	}
+}
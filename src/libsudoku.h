@@ -0,0 +1,68 @@
+/*
+//  libsudoku.h
+//  Sudoku Solver
+//
+//  Created by Jens Kwasniok on 19.10.26.
+//  Copyright © 2016 Jens Kwasniok. All rights reserved.
+//
+//  C interface of libsudoku.so (usable from C and from any runtime with a C foreign function interface)
+//
+//  A grid of dimension dim (4, 9, 16, ...) is passed as dim * dim bytes, one per cell in the order of the
+//  text format (row by row), zero stands for an empty cell. Several grids are stored one after another.
+//  All buffers are owned by the caller, the functions neither keep nor free them.
+*/
+
+#ifndef libsudoku_h
+#define libsudoku_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* version of this interface (incremented on incompatible changes) */
+#define SUDOKU_ABI_VERSION 2
+
+/* outcome of solving one grid (the values below 255 are the same as Solve_Status) */
+typedef uint8_t status_t;
+
+#define SUDOKU_SOLVED 0
+#define SUDOKU_CONTRADICTION 1
+#define SUDOKU_TIMEOUT 2
+#define SUDOKU_ASSUMPTION_LIMIT 3
+#define SUDOKU_MEMORY_LIMIT 4
+#define SUDOKU_CANCELLED 5
+/* the dimension is no square number or larger than 255, a value is larger than dim or a pointer is null */
+#define SUDOKU_INVALID 255
+
+/* returns SUDOKU_ABI_VERSION of the loaded library */
+unsigned int sudoku_abi_version(void);
+
+/* solves one grid
+   out receives the solution resp. the final cells of the unsolved grid (it may be the same as cells) */
+status_t solve_puzzle(const uint8_t* cells, size_t dim, uint8_t* out);
+
+/* solves n_puzzles grids by the given amount of threads (zero uses one thread per core, at most one thread
+   per 256 grids is used and fewer if threads cannot be started)
+   out receives n_puzzles grids (it may be the same as cells) and status one status per grid (all SUDOKU_INVALID if
+   dim is invalid or cells resp. out is null)
+   Standard 9x9 grids are solved in blocks via SIMD instructions and equivalent grids only once per thread.
+   returns the amount of solved grids */
+size_t solve_batch(const uint8_t* cells, size_t n_puzzles, size_t dim, uint8_t* out, status_t* status,
+				   unsigned int threads);
+
+/* counts the solutions of one grid up to limit (zero counts all) within time_limit_ms milliseconds (zero is no limit)
+   Counting all solutions of a grid with few givens may not end in any reasonable time without a time limit.
+   count receives the amount of solutions found (so far on SUDOKU_TIMEOUT); out (may be null) receives the first
+   solution
+   returns SUDOKU_SOLVED if at least one solution was found and the count is complete, SUDOKU_TIMEOUT otherwise */
+status_t count_solutions(const uint8_t* cells, size_t dim, uint64_t limit, uint64_t time_limit_ms, uint64_t* count,
+						 uint8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* libsudoku_h */
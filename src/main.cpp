@@ -7,43 +7,763 @@
 //
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <chrono>
+#include <string>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <math.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 #include "solve.h"
+#include "Search.h"
+#include "Singles.h"
+#include "Lockstep.h"
+#include "Checkpoint.h"
+#include "Pipeline.h"
+#include "Packed.h"
+#include "Hints.h"
+#include "Validate.h"
+#include "Portfolio.h"
+#include "Trace.h"
+#include "Generate.h"
+#include "Check.h"
 
 using namespace std;
 using namespace sudoku_solver;
 
-int main(int argc, const char * argv[]) {
+//! prints the reason and statistics of a solving attempt
+//! @param solutions prints the amount of solutions found (if they were counted)
+void print_stats(ostream& os, const Solve_Result& result, bool solutions = false) {
+	os << result.reason << " (assumptions: " << result.stats.assumptions
+	   << ", propagation rounds: " << result.stats.propagation_rounds
+	   << ", max depth: " << result.stats.max_depth;
+	if (result.stats.learned_nogoods != 0)
+		os << ", learned nogoods: " << result.stats.learned_nogoods
+		   << ", implied values: " << result.stats.nogood_implications;
+	if (result.stats.transposition_hits != 0)
+		os << ", transpositions: " << result.stats.transposition_hits;
+	if (result.stats.restarts != 0)
+		os << ", restarts: " << result.stats.restarts;
+	if (solutions)
+		os << ", solutions: " << result.stats.solutions;
+	os << ")" << endl;
+}
+
+//! parses the whole argument as unsigned number
+//! @return false if the argument contains anything but digits or does not fit into the type
+template <class T>
+bool parse_number(const char* arg, T& value) {
+	// strtoull would accept white space and a sign
+	if (!isdigit(arg[0]))
+		return false;
+	char* end = nullptr;
+	errno = 0;
+	unsigned long long v = strtoull(arg, &end, 10);
+	if (*end != '\0' || errno == ERANGE || v > numeric_limits<T>::max())
+		return false;
+	value = T(v);
+	return true;
+}
+
+//! parses the whole argument as number
+//! @return false if the argument is not a finite number in [min, max] or contains anything else
+bool parse_number(const char* arg, double& value, double min = 0, double max = numeric_limits<double>::max()) {
+	if (arg[0] == '\0' || isspace(arg[0]))
+		return false;
+	char* end = nullptr;
+	errno = 0;
+	double v = strtod(arg, &end);
+	if (*end != '\0' || errno == ERANGE || !isfinite(v) || v < min || v > max)
+		return false;
+	value = v;
+	return true;
+}
+
+void print_usage(ostream& os) {
+	os << "usage: main [--batch [cache size]] [--lockstep] [--threads <n>] [--portfolio [searches]] [--branching <order>] [--seed <n>] [--restarts <n>] [--count [limit]] [--pack <file>] [--unpack <file>] [--solve-packed <input> <output>] [--validate [packed file]] [--time-limit <ms>] [--assumption-limit <n>] [--memory-limit <MiB>] [--progress <n>] [--hints] [--checkpoint <file> [s]] [--resume <file>] [--trace <file>] [--backend <search|sat>] [--benchmark <dim> [grids]] [--givens <percent>] [--check [grids]] [--baseline <file>] [--save-baseline <file>] [--threshold <percent>] [--nogoods [capacity]] [--transpositions [MiB]] [--jigsaw] [--diagonal]" << endl;
+}
+
+//! options for variant sudokus
+struct Variant {
+	bool jigsaw = false;
+	bool diagonals = false;
+};
+
+//! options of the batch mode
+struct Batch_Options {
+	size_t cache_size = 4096;
+	//! solves blocks of 9x9 grids at once (see solve_lockstep)
+	bool lockstep = false;
+	//! amount of solver threads of the pipeline (zero solves all grids in the main thread)
+	unsigned int threads = 0;
+	//! amount of differently configured searches per grid (zero or one disables the portfolio)
+	unsigned int portfolio = 0;
+};
+
+//! reads the region index (1 to dim) per cell for jigsaw sudokus
+//! @return the layout of the variant or nullptr on failure
+unique_ptr<Grid_Layout> read_layout(istream& is, unsigned int dim, const Variant& variant) {
+	try {
+		if (!variant.jigsaw)
+			return unique_ptr<Grid_Layout>(new Grid_Layout(dim, variant.diagonals));
+		
+		vector<unsigned int> regions (dim * dim);
+		for (unsigned int& r : regions) {
+			is >> r;
+			if (!is || r == 0)
+				return nullptr;
+			--r;
+		}
+		return unique_ptr<Grid_Layout>(new Grid_Layout(dim, regions, variant.diagonals));
+	} catch (const invalid_argument& e) {
+		cerr << "invalid layout: " << e.what() << endl;
+		return nullptr;
+	}
+}
+
+//! solves all grids of the given dimension from the standard input until it ends
+//! (equivalent grids are solved only once via the solution cache)
+int batch(const Batch_Options& batch_options, const Solve_Limits& limits, const Search_Options& options, const Variant& variant) {
+	
+	unsigned short dim = 1;
+	cin >> dim;
+	// a grid without cells would be read again and again
+	if (dim == 0) {
+		cerr << "invalid dimension" << endl;
+		return 1;
+	}
+	
+	unique_ptr<Grid_Layout> layout = read_layout(cin, dim, variant);
+	if (!layout)
+		return 1;
+	
+	// one cache per thread (the cache is not synchronized)
+	vector<unique_ptr<Solution_Cache>> caches;
+	for (unsigned int t = 0; t < max(batch_options.threads, 1u); ++t)
+		caches.emplace_back(new Solution_Cache(batch_options.cache_size));
+	
+	const bool lockstep = batch_options.lockstep && options.backend == Backend::search && layout->is_standard() && dim == 9;
+	auto solve_block = [&](const vector<Single_Value_Sudoku_Grid>& grids, unsigned int thread) {
+		if (lockstep)
+			return solve_lockstep(grids, limits, options, caches[thread].get());
+		vector<Solve_Result> results;
+		for (const Single_Value_Sudoku_Grid& sg : grids) {
+			if (batch_options.portfolio > 1) {
+				results.push_back(solve_portfolio(sg, *layout, portfolio(batch_options.portfolio, options), limits));
+				continue;
+			}
+			// the symmetries used by the cache are only valid for standard sudokus
+			results.push_back(layout->is_standard() ? solve(sg, *caches[thread], limits, options)
+													: solve(sg, *layout, limits, options));
+		}
+		return results;
+	};
+	auto write = [&options](const Solve_Result& result) {
+		print_stats(cout, result, options.solution_limit != 1);
+		cout << result.grid << endl << endl;
+	};
+	
+	Single_Value_Sudoku_Grid sg(dim);
+	auto start = chrono::system_clock::now();
+	if (batch_options.threads != 0) {
+		// reading, solving and writing overlap
+		Pipeline_Options pipeline_options;
+		pipeline_options.workers = batch_options.threads;
+		pipeline_options.block_size = lockstep ? lockstep_lanes : 1;
+		Pipeline_Stats stats = run_pipeline([&](Single_Value_Sudoku_Grid& grid) {return bool(cin >> grid);},
+											solve_block, write, pipeline_options);
+		cerr << "grids: " << stats.grids
+			 << " max queue depth: " << stats.max_input_depth << " (input) " << stats.max_output_depth << " (output)" << endl
+			 << "stalls: reader " << stats.reader_stall.count() / 1000 << "ms workers "
+			 << stats.worker_input_stall.count() / 1000 << "ms (input) " << stats.worker_output_stall.count() / 1000 << "ms (output) writer "
+			 << stats.writer_stall.count() / 1000 << "ms" << endl;
+	} else {
+		// blocks of grids are read and solved at once if lockstep is enabled
+		vector<Single_Value_Sudoku_Grid> grids;
+		bool good = true;
+		while (good) {
+			grids.clear();
+			while (grids.size() < (lockstep ? lockstep_lanes : 1) && (good = bool(cin >> sg)))
+				grids.push_back(sg);
+			for (const Solve_Result& result : solve_block(grids, 0))
+				write(result);
+		}
+	}
+	auto stop = chrono::system_clock::now();
+	auto delta_t = chrono::duration_cast<chrono::milliseconds>(stop - start);
+	
+	unsigned long hits = 0, misses = 0, entries = 0;
+	for (const auto& cache : caches) {
+		hits += cache->hits();
+		misses += cache->misses();
+		entries += cache->size();
+	}
+	cerr << "time: " << delta_t.count() << "ms" << endl
+		 << "cache hits: " << hits << " misses: " << misses << " entries: " << entries << endl;
+	return 0;
+}
+
+//! converts grids of the text format (dimension followed by the grids) from the standard input to a packed file
+int pack(const string& path) {
 	
 	unsigned short dim = 1;
-	cout << "enter dimension of sudoku grid (must be square number): ";
 	cin >> dim;
 	
 	Single_Value_Sudoku_Grid sg(dim);
-	cout << "enter your sudoku grid of dimension " << sg.size() << "x" << sg.size() << ":" << endl;
-	cout << "example of a 9x9 grid: "
-		 << endl << "5 3 _ _ _ 2 1 _ 6"
-		 << endl << "_ _ 7 3 _ _ _ _ _"
-		 << endl << "2 _ _ _ 7 6 8 _ _"
-		 << endl << "_ _ 8 5 _ _ _ 1 7"
-		 << endl << "7 9 _ 4 _ 1 _ _ _"
-		 << endl << "1 _ _ _ _ 8 3 _ _"
-		 << endl << "8 _ _ 6 5 _ _ _ 1"
-		 << endl << "_ 7 _ _ _ 4 6 _ 5"
-		 << endl << "9 _ 5 1 _ _ _ 8 4" << endl << endl;
-
-	cin >> sg;
-	cout << (cin.good()? "accepted":"failed reading")  << endl << endl;
-	
-	if (cin.good()) {
-		auto start = chrono::system_clock::now();
-		Multiple_Value_Sudoku_Grid result = solve(sg);
-		auto stop = chrono::system_clock::now();
-		auto delta_t = chrono::duration_cast<chrono::milliseconds>(stop - start);
-
-		if (!result.solved())
-			print_grid(cout, result);
-		
-		cout << endl << endl << "result: (time " << delta_t.count() << "ms)" << endl << result << endl;
+	if (sg.size() == 0)
+		return 1;
+	try {
+		Packed_Writer writer {path, dim, false};
+		while (cin >> sg)
+			writer.write(sg);
+		if (!writer.close()) {
+			cerr << "failed writing " << path << endl;
+			return 1;
+		}
+	} catch (const runtime_error& e) {
+		cerr << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
+
+//! prints a packed file in the text format (results are preceded by their status)
+int unpack(const string& path) {
+	try {
+		Packed_File file {path};
+		Single_Value_Sudoku_Grid sg(file.size());
+		
+		cout << file.size() << endl;
+		for (uint64_t i = 0; i < file.count(); ++i) {
+			if (file.with_status())
+				cout << to_string(file.status(i)) << endl;
+			file.grid(i, sg);
+			cout << sg << endl << endl;
+		}
+	} catch (const runtime_error& e) {
+		cerr << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
+
+//! prints the result of a validation in one line
+void print_validation(ostream& os, const Validation_Result& result, const Grid_Layout& layout) {
+	const unsigned int n = layout.size();
+	if (result.solved()) {
+		os << "solved" << endl;
+	} else if (result.valid) {
+		os << "valid (incomplete)" << endl;
+	} else {
+		os << "conflict: value " << result.value;
+		if (result.value > n)
+			os << " out of range";
+		else
+			os << " twice in " << to_string(layout.kind(result.unit));
+		os << " at cell (" << result.cell / n + 1 << ", " << result.cell % n + 1 << ")" << endl;
+	}
+}
+
+//! validates grids of the text format from the standard input resp. of a packed file (one line per grid)
+int validate(const string& packed_path, const Variant& variant) {
+	
+	unsigned long grids = 0, solved = 0, conflicts = 0;
+	auto count = [&](const Validation_Result& result) {
+		++grids;
+		solved += result.solved();
+		conflicts += !result.valid;
+	};
+	
+	auto start = chrono::system_clock::now();
+	if (packed_path.empty()) {
+		unsigned short dim = 1;
+		cin >> dim;
+		unique_ptr<Grid_Layout> layout = read_layout(cin, dim, variant);
+		if (!layout)
+			return 1;
+		
+		Single_Value_Sudoku_Grid sg(dim);
+		while (cin >> sg) {
+			Validation_Result result = validate(sg, *layout);
+			print_validation(cout, result, *layout);
+			count(result);
+		}
+	} else {
+		try {
+			Packed_File file {packed_path};
+			const Grid_Layout& layout = Grid_Layout::standard(file.size());
+			const size_t cells = layout.cells();
+			
+			// blocks of grids are validated at once
+			const size_t block = 4096;
+			vector<uint8_t> values (block * cells);
+			vector<Validation_Result> results (block);
+			for (uint64_t begin = 0; begin < file.count(); begin += block) {
+				size_t size = size_t(min<uint64_t>(block, file.count() - begin));
+				for (size_t i = 0; i < size; ++i)
+					file.cells(begin + i, &values[i * cells]);
+				if (layout.size() == 9) {
+					validate_9x9(values.data(), size, results.data());
+				} else {
+					for (size_t i = 0; i < size; ++i)
+						results[i] = validate(&values[i * cells], layout);
+				}
+				for (size_t i = 0; i < size; ++i) {
+					print_validation(cout, results[i], layout);
+					count(results[i]);
+				}
+			}
+		} catch (const runtime_error& e) {
+			cerr << e.what() << endl;
+			return 1;
+		}
+	}
+	auto delta_t = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - start);
+	
+	cerr << "grids: " << grids << " solved: " << solved << " conflicts: " << conflicts << endl
+		 << "time: " << delta_t.count() << "ms" << endl;
+	return 0;
+}
+
+//! prints one deduction after another until the grid is solved, contains a contradiction or a limit is reached
+void print_hints(const Single_Value_Sudoku_Grid& sg, const Grid_Layout& layout,
+				 const Solve_Limits& limits, const Search_Options& options) {
+	
+	Hint_Solver solver {sg, layout};
+	const unsigned int n = layout.size();
+	
+	for (Hint hint = solver.step(true, limits, options); ; hint = solver.step(true, limits, options)) {
+		if (hint.rule == Hint_Rule::solved || hint.rule == Hint_Rule::contradiction || hint.rule == Hint_Rule::interrupted) {
+			cout << to_string(hint.rule) << endl;
+			break;
+		}
+		cout << "cell (" << hint.cell / n + 1 << ", " << hint.cell % n + 1 << "): "
+			 << (hint.rule == Hint_Rule::pointing ? "cancel " : "") << hint.value
+			 << " (" << to_string(hint.rule);
+		if (hint.rule == Hint_Rule::hidden_single || hint.rule == Hint_Rule::pointing)
+			cout << " in " << to_string(layout.kind(hint.unit));
+		cout << ")" << endl;
+	}
+	cout << endl << solver.grid() << endl;
+}
+
+//! runs the search in slices to report its progress and to write checkpoints
+//! @param progress_interval amount of assumptions between progress reports (zero disables them)
+//! @param checkpoint_path file of the checkpoints (empty disables them)
+Solve_Result run(Search_Engine& engine, unsigned long progress_interval,
+				 const string& checkpoint_path, chrono::seconds checkpoint_interval) {
+	
+	unique_ptr<Checkpoint_Writer> writer;
+	if (!checkpoint_path.empty())
+		writer.reset(new Checkpoint_Writer(checkpoint_path));
+	auto last_checkpoint = chrono::steady_clock::now();
+	
+	while (!engine.run(progress_interval != 0 ? progress_interval : 1000)) {
+		if (progress_interval != 0) {
+			cerr << "assumptions: " << engine.stats().assumptions << " depth: " << engine.depth()
+				 << " explored: " << engine.progress() * 100.0 << "%"
+				 << " final cells: " << engine.final_cells() << " candidates: " << engine.candidates() << endl;
+		}
+		
+		// the state is copied and written in the background while the search continues
+		auto now = chrono::steady_clock::now();
+		if (writer && now - last_checkpoint >= checkpoint_interval) {
+			ostringstream os;
+			engine.save(os);
+			if (writer->write(os.str()))
+				last_checkpoint = now;
+		}
+	}
+	
+	if (writer && !writer->wait())
+		cerr << "failed writing checkpoint " << checkpoint_path << endl;
+	return engine.result();
+}
+
+//! solves the same random grids of the given dimension with each backend and compares their times
+//! @param givens fraction of the cells which keep their value
+int benchmark(unsigned int dim, unsigned long grids, double givens, const Solve_Limits& limits, const Search_Options& options) {
+	
+	const unsigned int box_size = (unsigned int) sqrt(double(dim));
+	if (dim == 0 || box_size * box_size != dim) {
+		cerr << "dimension must be a square number" << endl;
+		return 1;
+	}
+	
+	mt19937_64 random {options.seed};
+	vector<Single_Value_Sudoku_Grid> puzzles;
+	for (unsigned long i = 0; i < grids; ++i)
+		puzzles.push_back(random_puzzle(random_solution(dim, random), givens, random));
+	
+	cout << grids << " grids of dimension " << dim << "x" << dim << " with " << givens * 100 << "% givens" << endl;
+	for (Backend backend : {Backend::search, Backend::sat}) {
+		Search_Options backend_options = options;
+		backend_options.backend = backend;
+		
+		unsigned long solved = 0, interrupted = 0;
+		chrono::microseconds total {0}, slowest {0};
+		for (const Single_Value_Sudoku_Grid& sg : puzzles) {
+			Solve_Result result = solve(sg, Grid_Layout::standard(dim), limits, backend_options);
+			solved += result.status == Solve_Status::solved;
+			interrupted += result.status != Solve_Status::solved && result.status != Solve_Status::contradiction;
+			total += result.stats.time;
+			slowest = max(slowest, result.stats.time);
+		}
+		cout << to_string(backend) << ": solved " << solved << " interrupted " << interrupted
+			 << " total " << total.count() / 1000 << "ms mean " << total.count() / 1000.0 / max(grids, 1ul)
+			 << "ms max " << slowest.count() / 1000 << "ms" << endl;
+	}
+	return 0;
+}
+
+//! solves random grids by all engines, reports wrong results and compares the timings with a baseline
+//! @param baseline_path file of the baseline timings (empty skips the comparison)
+//! @param save_path file which receives the timings as new baseline (may be empty)
+//! @param threshold allowed slowdown as fraction of the baseline
+//! @return 1 if a result was wrong or an engine slower than the threshold allows
+int check(const Check_Options& check_options, const string& baseline_path, const string& save_path, double threshold) {
+	
+	Check_Report report = check_engines(check_options);
+	for (const string& failure : report.failures)
+		cout << "FAILED " << failure << endl;
+	
+	vector<string> regressions;
+	if (!baseline_path.empty()) {
+		try {
+			ifstream file {baseline_path};
+			if (!file)
+				throw runtime_error("cannot open " + baseline_path);
+			regressions = timing_regressions(report.timings, read_timings(file), threshold);
+		} catch (const runtime_error& e) {
+			cerr << e.what() << endl;
+			return 1;
+		}
+	}
+	for (const string& regression : regressions)
+		cout << "REGRESSION " << regression << endl;
+	
+	for (const Check_Timing& t : report.timings)
+		cout << t.engine << " " << t.size << "x" << t.size << ": " << t.time.count() / 1000.0 << "ms" << endl;
+	cout << report.grids << " grids, " << report.runs << " results, " << report.failures.size() << " failures, "
+		 << regressions.size() << " regressions" << endl;
+	
+	if (!save_path.empty()) {
+		ofstream file {save_path};
+		write_timings(file, report.timings);
+		if (!file)
+			cerr << "failed writing " << save_path << endl;
+	}
+	return report.failures.empty() && regressions.empty() ? 0 : 1;
+}
+
+//! writes the recorded events as Chrome trace-event JSON (if the file name ends with .json) or as binary log
+void write_trace(const Search_Tracer& tracer, const string& path) {
+	bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+	ofstream file {path, json ? ios::out : ios::out | ios::binary};
+	if (json)
+		tracer.write_json(file);
+	else
+		tracer.write_binary(file);
+	if (!file)
+		cerr << "failed writing trace " << path << endl;
+	else
+		cerr << "trace events: " << tracer.events() << " dropped: " << tracer.dropped() << endl;
+}
+
+int main(int argc, const char * argv[]) {
+	
+	Solve_Limits limits;
+	Search_Options options;
+	Variant variant;
+	unsigned long progress_interval = 0;
+	string checkpoint_path;
+	chrono::seconds checkpoint_interval {60};
+	string resume_path;
+	bool batch_mode = false;
+	bool hints = false;
+	bool validation = false;
+	string validate_path;
+	Batch_Options batch_options;
+	string pack_path, unpack_path, packed_input, packed_output;
+	string trace_path;
+	unsigned int benchmark_dim = 0;
+	unsigned long benchmark_grids = 10;
+	double givens = 0.4;
+	bool checking = false;
+	Check_Options check_options;
+	string baseline_path, save_baseline_path;
+	double threshold = 0.5;
+	unique_ptr<Search_Tracer> tracer;
+	
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool has_next = i + 1 < argc;
+		// parses the next argument into value
+		bool number_valid = true;
+		auto number = [&](auto& value) {number_valid = parse_number(argv[++i], value);};
+		unsigned long ms = 0, mib = 0, seconds = 0;
+		if (arg == "--batch") {
+			batch_mode = true;
+			if (has_next && isdigit(argv[i + 1][0]))
+				number(batch_options.cache_size);
+		} else if (arg == "--validate") {
+			validation = true;
+			if (has_next && argv[i + 1][0] != '-')
+				validate_path = argv[++i];
+		} else if (arg == "--hints") {
+			hints = true;
+		} else if (arg == "--pack" && has_next) {
+			pack_path = argv[++i];
+		} else if (arg == "--unpack" && has_next) {
+			unpack_path = argv[++i];
+		} else if (arg == "--solve-packed" && i + 2 < argc) {
+			packed_input = argv[++i];
+			packed_output = argv[++i];
+		} else if (arg == "--threads" && has_next) {
+			number(batch_options.threads);
+		} else if (arg == "--portfolio") {
+			batch_options.portfolio = max(thread::hardware_concurrency(), 4u);
+			if (has_next && isdigit(argv[i + 1][0]))
+				number(batch_options.portfolio);
+		} else if (arg == "--branching" && has_next) {
+			if (!parse_branching(argv[++i], options.branching)) {
+				cerr << "unknown branching " << argv[i] << " (scan, random, degree or constraint)" << endl;
+				return 1;
+			}
+		} else if (arg == "--count") {
+			options.solution_limit = 0;
+			if (has_next && isdigit(argv[i + 1][0]))
+				number(options.solution_limit);
+		} else if (arg == "--seed" && has_next) {
+			number(options.seed);
+		} else if (arg == "--restarts" && has_next) {
+			number(options.restart_interval);
+		} else if (arg == "--lockstep") {
+			batch_options.lockstep = true;
+		} else if (arg == "--time-limit" && has_next) {
+			number(ms);
+			limits.time = chrono::milliseconds(ms);
+		} else if (arg == "--assumption-limit" && has_next) {
+			number(limits.assumptions);
+		} else if (arg == "--memory-limit" && has_next) {
+			number(mib);
+			limits.memory = mib * 1024 * 1024;
+		} else if (arg == "--nogoods") {
+			options.nogood_capacity = 1 << 16;
+			if (has_next && isdigit(argv[i + 1][0]))
+				number(options.nogood_capacity);
+		} else if (arg == "--transpositions") {
+			options.transposition_memory = 16 * 1024 * 1024;
+			if (has_next && isdigit(argv[i + 1][0])) {
+				number(mib);
+				options.transposition_memory = mib * 1024 * 1024;
+			}
+		} else if (arg == "--jigsaw") {
+			variant.jigsaw = true;
+		} else if (arg == "--diagonal") {
+			variant.diagonals = true;
+		} else if (arg == "--progress" && has_next) {
+			number(progress_interval);
+		} else if (arg == "--checkpoint" && has_next) {
+			checkpoint_path = argv[++i];
+			if (i + 1 < argc && isdigit(argv[i + 1][0])) {
+				number(seconds);
+				checkpoint_interval = chrono::seconds(seconds);
+			}
+		} else if (arg == "--backend" && has_next) {
+			if (!parse_backend(argv[++i], options.backend)) {
+				cerr << "unknown backend " << argv[i] << " (search or sat)" << endl;
+				return 1;
+			}
+		} else if (arg == "--benchmark" && has_next) {
+			number(benchmark_dim);
+			if (i + 1 < argc && isdigit(argv[i + 1][0]))
+				number(benchmark_grids);
+		} else if (arg == "--givens" && has_next) {
+			number_valid = parse_number(argv[++i], givens, 0, 100);
+			givens /= 100;
+		} else if (arg == "--check") {
+			checking = true;
+			if (i + 1 < argc && isdigit(argv[i + 1][0]))
+				number(check_options.grids);
+		} else if (arg == "--baseline" && has_next) {
+			baseline_path = argv[++i];
+		} else if (arg == "--save-baseline" && has_next) {
+			save_baseline_path = argv[++i];
+		} else if (arg == "--threshold" && has_next) {
+			number(threshold);
+			threshold /= 100;
+		} else if (arg == "--trace" && has_next) {
+			trace_path = argv[++i];
+		} else if (arg == "--resume" && has_next) {
+			resume_path = argv[++i];
+		} else {
+			cerr << "unknown argument " << arg << endl;
+			print_usage(cerr);
+			return 1;
+		}
+		if (!number_valid) {
+			cerr << "invalid number " << argv[i] << " for " << arg << endl;
+			print_usage(cerr);
+			return 1;
+		}
 	}
+	
+	if (!trace_path.empty()) {
+		tracer.reset(new Search_Tracer);
+		options.tracer = tracer.get();
+	}
+	
+	if (validation)
+		return validate(validate_path, variant);
+	if (checking) {
+		// an attempt which does not end is a failure
+		check_options.seed = options.seed;
+		check_options.limits = limits;
+		if (check_options.limits.time.count() == 0)
+			check_options.limits.time = chrono::milliseconds(10000);
+		return check(check_options, baseline_path, save_baseline_path, threshold);
+	}
+	if (benchmark_dim != 0) {
+		// unsolvable grids would run forever without a limit
+		if (limits.time.count() == 0)
+			limits.time = chrono::milliseconds(10000);
+		return benchmark(benchmark_dim, benchmark_grids, givens, limits, options);
+	}
+	if (!pack_path.empty())
+		return pack(pack_path);
+	if (!unpack_path.empty())
+		return unpack(unpack_path);
+	if (!packed_input.empty()) {
+		try {
+			auto start = chrono::system_clock::now();
+			Packed_Stats stats = solve_packed(packed_input, packed_output, limits, options,
+											  max(batch_options.threads, 1u), batch_options.cache_size);
+			auto delta_t = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now() - start);
+			cerr << "grids: " << stats.grids << " solved: " << stats.solved << " cache hits: " << stats.cache_hits << endl
+				 << "time: " << delta_t.count() << "ms" << endl;
+			if (tracer)
+				write_trace(*tracer, trace_path);
+		} catch (const runtime_error& e) {
+			cerr << e.what() << endl;
+			return 1;
+		}
+		return 0;
+	}
+	
+	if (batch_mode) {
+		int ret = batch(batch_options, limits, options, variant);
+		if (tracer)
+			write_trace(*tracer, trace_path);
+		return ret;
+	}
+	
+	unique_ptr<Grid_Layout> layout;
+	unique_ptr<Search_Engine> engine;
+	Single_Value_Sudoku_Grid sg;
+	
+	if (!resume_path.empty()) {
+		try {
+			ifstream file {resume_path, ios::binary};
+			if (!file)
+				throw runtime_error("cannot open " + resume_path);
+			layout = Search_Engine::read_header(file);
+			engine.reset(new Search_Engine(file, *layout, limits, options));
+		} catch (const runtime_error& e) {
+			cerr << "failed resuming: " << e.what() << endl;
+			return 1;
+		}
+		cout << "resuming search of a grid of dimension " << layout->size() << "x" << layout->size()
+			 << " after " << engine->stats().assumptions << " assumptions" << endl << endl;
+	} else {
+		unsigned short dim = 1;
+		cout << "enter dimension of sudoku grid (must be square number): ";
+		cin >> dim;
+		
+		if (variant.jigsaw)
+			cout << "enter the region (1 to " << dim << ") of each cell:" << endl;
+		layout = read_layout(cin, dim, variant);
+		if (!layout) {
+			cout << "failed reading" << endl;
+			return 1;
+		}
+		
+		sg = Single_Value_Sudoku_Grid(dim);
+		cout << "enter your sudoku grid of dimension " << sg.size() << "x" << sg.size() << ":" << endl;
+		cout << "example of a 9x9 grid: "
+			 << endl << "5 3 _ _ _ 2 1 _ 6"
+			 << endl << "_ _ 7 3 _ _ _ _ _"
+			 << endl << "2 _ _ _ 7 6 8 _ _"
+			 << endl << "_ _ 8 5 _ _ _ 1 7"
+			 << endl << "7 9 _ 4 _ 1 _ _ _"
+			 << endl << "1 _ _ _ _ 8 3 _ _"
+			 << endl << "8 _ _ 6 5 _ _ _ 1"
+			 << endl << "_ 7 _ _ _ 4 6 _ 5"
+			 << endl << "9 _ 5 1 _ _ _ 8 4" << endl << endl;
+		
+		cin >> sg;
+		cout << (cin.good()? "accepted":"failed reading")  << endl << endl;
+		if (!cin.good())
+			return 0;
+		
+		if (hints) {
+			try {
+				print_hints(sg, *layout, limits, options);
+			} catch (const invalid_argument& e) {
+				cerr << e.what() << endl;
+				return 1;
+			}
+			return 0;
+		}
+	}
+	
+	auto start = chrono::system_clock::now();
+	Solve_Result result;
+	if (!engine && batch_options.portfolio > 1) {
+		vector<Search_Options> configurations = portfolio(batch_options.portfolio, options);
+		size_t winner = 0;
+		result = solve_portfolio(sg, *layout, configurations, limits, &winner);
+		cout << "portfolio: " << to_string(configurations[winner].branching) << " order";
+		if (configurations[winner].branching == Branching::random)
+			cout << " (seed " << configurations[winner].seed << ")";
+		cout << " of " << configurations.size() << " searches" << endl;
+	} else if (!engine && (options.backend == Backend::sat || (progress_interval == 0 && checkpoint_path.empty()))) {
+		result = solve(sg, *layout, limits, options);
+	} else {
+		// grids solved by singles are neither reported nor saved
+		Multiple_Value_Sudoku_Grid mg {sg.size()};
+		Solve_Stats singles_stats;
+		if (!engine && solve_singles(sg, *layout, mg, singles_stats)) {
+			result.grid = std::move(mg);
+			result.status = Solve_Status::solved;
+			result.reason = "solved";
+			result.stats = singles_stats;
+		} else {
+			if (!engine)
+				engine.reset(new Search_Engine(std::move(mg), *layout, limits, options));
+			result = run(*engine, progress_interval, checkpoint_path, checkpoint_interval);
+			result.stats.propagation_rounds += singles_stats.propagation_rounds;
+			result.stats.time += singles_stats.time;
+		}
+	}
+	auto stop = chrono::system_clock::now();
+	auto delta_t = chrono::duration_cast<chrono::milliseconds>(stop - start);
+	
+	print_stats(cout, result, options.solution_limit != 1);
+	
+	if (result.status != Solve_Status::solved)
+		print_grid(cout, result.grid);
+	
+	cout << endl << endl << "result: (time " << delta_t.count() << "ms)" << endl << result.grid << endl;
+	
+	if (tracer)
+		write_trace(*tracer, trace_path);
 }
@@ -9,39 +9,17 @@
 #include "solve.h"
 
 #include <iostream>
-#include <map>
+#include "Search.h"
+#include "Sat.h"
+#include "Singles.h"
 #include "util.h"
+#include "canonical.h"
 
 namespace sudoku_solver {
 	
-	//! converts the multiple valued grid into a single valued grid
-	//! with all empty cells filled with all possible (1 to max_value) values
-	Multiple_Value_Sudoku_Grid create_possibility_grid(const Single_Value_Sudoku_Grid& rhs);
-
-	//! special return type for _solve
-	struct _solve_ret_t {
-		Multiple_Value_Sudoku_Grid grid;
-		bool solved = false;
-		std::string reason;
-	};
-
-	//! recursive implementation of solving algoritm
-	_solve_ret_t _solve(Multiple_Value_Sudoku_Grid&& mg_start,
-						std::map<int, std::vector<value_t>> boxes = {}, // stores the final values per box
-						std::map<int, std::vector<value_t>> lines_x = {}, // stores the final values per line in x-direction
-						std::map<int, std::vector<value_t>> lines_y = {}); // stores the final values per line in y-direction
-
-
-	
 	Multiple_Value_Sudoku_Grid solve(const Single_Value_Sudoku_Grid& sg_start) {
 		
-		// convert (single valued) sudoku grid into initial grid with multiple-value support
-		// this new grid copies all values from its original and fills all blank cells
-		// with all possible values (e.g. 1-9 for a 9x9 grid)
-		Multiple_Value_Sudoku_Grid mg {create_possibility_grid(sg_start)};
-		
-		// call to recursive solving algorithm
-		_solve_ret_t mg_solved = _solve(std::move(mg));
+		Solve_Result mg_solved = solve(sg_start, Solve_Limits());
 		
 		// prints the reason why the solving algorithm finished
 		// either 'solved' or a contradiction message (e.g. 'same value in box')
@@ -51,465 +29,108 @@ namespace sudoku_solver {
 		// the grid might be in an unsolved state
 		return std::move(mg_solved.grid);
 	}
+	
+	Solve_Result solve(const Single_Value_Sudoku_Grid& sg_start, const Solve_Limits& limits) {
 		
-	_solve_ret_t _solve(Multiple_Value_Sudoku_Grid&& mg_start,
-						std::map<int, std::vector<value_t>> boxes,
-						std::map<int, std::vector<value_t>> lines_x,
-						std::map<int, std::vector<value_t>> lines_y)
-	{
-		Multiple_Value_Sudoku_Grid mg {std::move(mg_start)};
+		return solve(sg_start, Grid_Layout::standard(sg_start.size()), limits);
+	}
+	
+	Solve_Result solve(const Single_Value_Sudoku_Grid& sg_start, const Grid_Layout& layout,
+					   const Solve_Limits& limits, const Search_Options& options) {
 		
-		// synopsis:
-		//
-		// step I: (analytical part)
-		//
-		//    a: find cells with one possibility only and finalize them
-		//    a.a: find non-final cells with only one possibility
-		//        for each such cell:
-		//            mark the value as used for its segements (box and lines)
-		//            mark it as final
-		//    a.b: find single occurrence of a value in a section
-		//        mark those cells as final
-		//    (Both sub-steps might return with a contradiction.)
-		//
-		//    b: cancel possibilities
-		//    b.a: cancel no longer possible values form all cells via marked-as-used values per section
-		//    b.b: cancles possibilities due to 'blocking' of a value whose position in one box is fixed to one line
-		//         (The position of the value is known for the line in one direction. It can be treated as if a final
-		//          value cancled the possibility of this value in the same line inside the other boxes.)
-		//
-		//
-		// step II: (assumption based part)
-		//
-		//    for each possibility in a non-final cell:
-		//        apply the solving algorithm to a copy with just one possibility cancled out
-		//    return (solved or contradictory) grid
-		//    (This brute force method complements the analytical step and is necessary for ambigous sudokus.)
-		//
+		if (options.backend == Backend::sat)
+			return solve_sat(sg_start, layout, limits, options);
 		
-		// decides whether step II is applied
-		bool grid_not_final;
-		// tracks the amount of removed possibilities (if it differs from 0 step I is repeated)
-		unsigned int removed_possibilities;
+		// easy grids are solved by singles alone, all others start from the possible values left by them
+		// (the grid is either solved or contains all possible values of each cell, e.g. 1-9 for a 9x9 grid)
+		Multiple_Value_Sudoku_Grid mg {sg_start.size()};
+		Solve_Stats singles_stats;
+		if (solve_singles(sg_start, layout, mg, singles_stats))
+			return {std::move(mg), Solve_Status::solved, "solved", singles_stats};
 		
-		// step I: analyze and cancle possibilities
-		do {
-			grid_not_final = false;
-			removed_possibilities = 0;
-			
-			// Ia: analyze cells for final values (via box and lines)
-			
-			// Ia.a: find cell with one possible value left which is not marked as final
-			for (int x = 0; x < mg.size(); ++x) {
-				for (int y = 0; y < mg.size(); ++y) {
-					
-					Multiple_Value_Cell& cell = mg.get_cell(x,y);
-					
-					if (!cell.is_final() && cell.possibilities() == 1) {
-						
-						// shortcuts to cell and sections
-						value_t v = cell.get_values()[0];
-						std::vector<value_t>& box = boxes[mg.get_box_index(x, y)];
-						std::vector<value_t>& line_x = lines_x[x];
-						std::vector<value_t>& line_y = lines_y[y];
-						
-						// check for contradictions and stop if one occurred
-						// or store final value as 'used' in section and continue
-						if(has_value(box, v))
-							return {std::move(mg), false, "same value in box"};
-						else
-							box.push_back(v);
-						
-						if(has_value(line_x, v))
-							return {std::move(mg), false, "same value in vertical line"};
-						else
-							line_x.push_back(v);
-						
-						if(has_value(line_y, v))
-							return {std::move(mg), false, "same value in horizontal line"};
-						else
-							line_y.push_back(v);
-						
-						// mark cell as final
-						cell.make_final();
-					}
-				}
-			}
-			
-			// Ia.b: find single occurrence of a value in a section
-			
-			// for each value
-			for (value_t v = 1; v <= mg.size(); ++v) {
-				
-				// indicates weather the value v occurred just onnce in the current section
-				bool value_occurred_once;
-				// stores the position of that cell (only valid, if value_occurred_once is true)
-				int cell_pos_x, cell_pos_y;
-				
-				// by vertical line
-				for (int x = 0; x < mg.size(); ++x) {
-					
-					// if the value v does appear as final value in this section,
-					// there is no need to check for a single occurence
-					if (!has_value(lines_x[x], v)) {
-						
-						value_occurred_once = false;
-						
-						for (int y = 0; y < mg.size(); ++y) {
-							
-							if (has_value(mg.get_cell(x, y).get_values(), v)) {
-								
-								if (value_occurred_once) {value_occurred_once = false; break;} // occurred twice
-								value_occurred_once = true;
-								cell_pos_x = x;
-								cell_pos_y = y;
-								
-							}
-						}
-						
-						if (value_occurred_once) {
-								
-							// shortcuts to cell & sections
-							Multiple_Value_Cell& c = mg.get_cell(cell_pos_x, cell_pos_y);
-							std::vector<value_t>& box = boxes[mg.get_box_index(cell_pos_x, cell_pos_y)];
-							std::vector<value_t>& line_x = lines_x[cell_pos_x];
-							std::vector<value_t>& line_y = lines_y[cell_pos_y];
-							
-							// check for contradictions and stop if one occurred
-							// or store final value as used in section and continue
-							if(has_value(box, v))
-								return {std::move(mg), false, "same value in box"};
-							else
-								box.push_back(v);
-							
-							line_x.push_back(v);
-							
-							if(has_value(line_y, v))
-								return {std::move(mg), false, "same value in horizontal line"};
-							else
-								line_y.push_back(v);
-							
-							// cancel all other possible values for this cell
-							c.set_values({v});
-							// mark cell as final
-							c.make_final();
-						}
-						
-					}
-					
-				}
-				
-				// by horizontal line
-				for (int y = 0; y < mg.size(); ++y) {
-					
-					// if the value v does appear as final value in this section,
-					// there is no need to check for a single occurence
-					if (!has_value(lines_y[y], v)) {
-						
-						value_occurred_once = false;
-						
-						for (int x = 0; x < mg.size(); ++x) {
-							
-							if (has_value(mg.get_cell(x, y).get_values(), v)) {
-								
-								if (value_occurred_once) {value_occurred_once = false; break;} // occurred twice
-								value_occurred_once = true;
-								cell_pos_x = x;
-								cell_pos_y = y;
-								
-							}
-						}
-						
-						if (value_occurred_once) {
-							
-							// shortcuts to cell & sections
-							Multiple_Value_Cell& c = mg.get_cell(cell_pos_x, cell_pos_y);
-							std::vector<value_t>& box = boxes[mg.get_box_index(cell_pos_x, cell_pos_y)];
-							std::vector<value_t>& line_x = lines_x[cell_pos_x];
-							std::vector<value_t>& line_y = lines_y[cell_pos_y];
-							
-							// check for contradictions and stop if one occurred
-							// or store final value as used in section and continue
-							if(has_value(box, v))
-								return {std::move(mg), false, "same value in box"};
-							else
-								box.push_back(v);
-							
-							if(has_value(line_x, v))
-								return {std::move(mg), false, "same value in vertical line"};
-							else
-								line_x.push_back(v);
-
-								line_y.push_back(v);
-							
-							// cancel all other possible values for this cell
-							c.set_values({v});
-							// mark cell as final
-							c.make_final();
-						}
-						
-					}
-					
-				}
-				
-				// by box
-				for (int b = 0; b < mg.size() ; ++b) {
-					
-					// if the value v does appear as final value in this section,
-					// there is no need to check for a single occurence
-					if (!has_value(boxes[b], v)) {
-						
-						value_occurred_once = false;
-						
-						std::pair<int, int> c_coord_box = mg.get_left_top_cell_coord_of_box(b);
-						int x_box = c_coord_box.first;
-						int y_box = c_coord_box.second;
-						
-						bool brk = false; // brk (break)
-						for (int x_rel = 0; !brk && x_rel < mg.box_size(); ++x_rel) {
-							for (int y_rel = 0; y_rel < mg.box_size(); ++y_rel) {
-						
-							
-								if (has_value(mg.get_cell(x_box + x_rel, y_box + y_rel).get_values(), v)) {
-									
-									if (value_occurred_once) {value_occurred_once = false; brk = true; break;} // occurred twice
-									value_occurred_once = true;
-									cell_pos_x = x_box + x_rel;
-									cell_pos_y = y_box + y_rel;
-									
-								}
-							}
-						}
-						
-						if (value_occurred_once) {
-							
-							// shortcuts to cell & sections
-							Multiple_Value_Cell& c = mg.get_cell(cell_pos_x, cell_pos_y);
-							std::vector<value_t>& box = boxes[mg.get_box_index(cell_pos_x, cell_pos_y)];
-							std::vector<value_t>& line_x = lines_x[cell_pos_x];
-							std::vector<value_t>& line_y = lines_y[cell_pos_y];
-							
-							// check for contradictions and stop if one occurred
-							// or store final value as used in section and continue
-							box.push_back(v);
-							
-							if(has_value(line_x, v))
-								return {std::move(mg), false, "same value in vertical line"};
-							else
-								line_x.push_back(v);
-							
-							if(has_value(line_y, v))
-								return {std::move(mg), false, "same value in horizontal line"};
-							else
-								line_y.push_back(v);
-							
-							// cancel all other possible values for this cell
-							c.set_values({v});
-							// mark cell as final
-							c.make_final();
-						}
-						
-					}
-					
-				}
-			
-			}
-			
-			// Ib.a: cancel no longer possible values (due to final values)
-			for (int x = 0; x < mg.size(); ++x) {
-				for (int y = 0; y < mg.size(); ++y) {
-					
-					// shortcuts to cell and its values
-					Multiple_Value_Cell& cell = mg.get_cell(x,y);
-					std::vector<value_t>& cell_vs = cell.get_values();
-					
-					// find non-final cell
-					if (!cell.is_final()) {
-						
-						// try to remove the values stored as used in all sections corresponding to the current cell
-						// if the remove was possible increment the counter
-						for (value_t v : boxes[mg.get_box_index(x, y)]) {
-							if (removed(cell_vs, v))
-								++removed_possibilities;
-						}
-						for (value_t v : lines_x[x]) {
-							if (removed(cell_vs, v))
-								++removed_possibilities;
-						}
-						for (value_t v : lines_y[y]) {
-							if (removed(cell_vs, v))
-								++removed_possibilities;
-						}
-						
-						// if one cell is empty the grid contains a contradiction
-						if (cell.is_empty())
-							return {std::move(mg), false, "no possible value for cell"};
-						
-						// remember if at least one cell is non-final
-						if (!cell.is_final())
-							grid_not_final = true;
-					}
-				}
-			}
-			
-			// Ib.b cancles possibilities due to 'blocking' of a value whose position in a box is fixed to one line
-			// apply this for each box
-			for (int b_x = 0; b_x < mg.box_size(); ++b_x) {
-				for (int b_y = 0; b_y < mg.box_size(); ++b_y) {
-					
-					// store all possible values in this box per line
-					std::vector<std::vector<value_t>> line_x_rel (mg.box_size());
-					std::vector<std::vector<value_t>> line_y_rel (mg.box_size());
-					
-					// for each cell in this box (coords relative to top left cell in box)
-					for (int x_rel = 0; x_rel < mg.box_size(); ++x_rel) {
-						for (int y_rel = 0; y_rel < mg.box_size(); ++y_rel) {
-							
-							//shortcut to current cell
-							Multiple_Value_Cell& c = mg.get_cell(b_x * mg.box_size() + x_rel, b_y * mg.box_size() + y_rel);
-							
-							// store the possible values per line
-							for (value_t v : c.get_values()) {
-								
-								if (!has_value(line_x_rel[x_rel], v))
-									line_x_rel[x_rel].push_back(v);
-								
-								if (!has_value(line_y_rel[y_rel], v))
-									line_y_rel[y_rel].push_back(v);
-							}
-						}
-					}
-					
-					// histogramms to analyze the frequency of a value in a line
-					std::map<value_t, int> histogramm_x;
-					std::map<value_t, int> histogramm_y;
-					
-					// for each line increment the fequency for every such value
-					for (int i_rel = 0; i_rel < mg.box_size(); ++i_rel) {
-						for (value_t v : line_x_rel[i_rel])
-							++histogramm_x[v];
-						for (value_t v : line_y_rel[i_rel])
-							++histogramm_y[v];
-					}
-					
-					// find values which occurre in only one line (frequency of one)
-					// and store them
-					std::vector<value_t> single_values_x;
-					std::vector<value_t> single_values_y;
-					for (auto& v : histogramm_x) {
-						if (v.second == 1)
-							single_values_x.push_back(v.first);
-					}
-					for (auto& v : histogramm_y) {
-						if (v.second == 1)
-							single_values_y.push_back(v.first);
-					}
-					
-					// find values of frequency one in each line and remove the possibility along this line of this value
-					// except the possibilities inside the current box:
-					
-					// for each line
-					for (int i_rel = 0; i_rel < mg.box_size(); ++i_rel) {
-						
-						// x-direction
-						// if the values occured in this line
-						for (value_t v : single_values_x) {
-							if (has_value(line_x_rel[i_rel], v)) {
-								
-								// for this line remove v from other boxes on this line
-								for (int i = 0; i < mg.box_size(); ++i) {
-									if (i == i_rel) continue;
-									
-									// for each cell in this line except the cells in this box
-									for (int y = 0; y < mg.size(); ++y) {
-										if (b_y * mg.box_size() <= y && y < (b_y + 1) * mg.box_size()) continue;
-										
-										std::vector<value_t>& vs = mg.get_cell(b_x * mg.box_size() + i_rel, y).get_values();
-										if (removed(vs, v))
-											++removed_possibilities;
-										
-									}
-								}
-							}
-						}
-						
-						// y-direction
-						// if the values occured in this line
-						for (value_t v : single_values_y) {
-							if (has_value(line_y_rel[i_rel], v)) {
-								
-								// for this line remove v from other boxes on this line
-								for (int i = 0; i < mg.box_size(); ++i) {
-									if (i == i_rel) continue;
-									
-									// for each cell in this line except the cells in this box
-									for (int x = 0; x < mg.size(); ++x) {
-										if (b_x * mg.box_size() <= x && x < (b_x + 1) * mg.box_size()) continue;
-										
-										std::vector<value_t>& vs = mg.get_cell(x, b_y * mg.box_size() + i_rel).get_values();
-										if (removed(vs, v))
-											++removed_possibilities;
-										
-									}
-								}
-							}
-						}
-						
-					}
-					
-				}
-			}
-			
-#if DEBUG
-			print_grid(std::cout, mg);
-			std::cout << std::endl << std::endl;
-#endif
-		// continue until analyzing and canceling results in no changes
-		} while (removed_possibilities != 0);
+		// call to (iterative) solving algorithm
+		Search_Engine engine {std::move(mg), layout, limits, options};
+		engine.run();
 		
-		// apply step II if necessary or return solved grid otherwise
-		if (grid_not_final) {
-			
-			// step II: cancle one value by pure assumption
-			
-			// for each possibility to cancle a non-final value
-			// (cells with fewer possibilities are chosen first)
-			for (int i = 2; i <= mg.size(); ++i) {
-				for (int x = 0; x < mg.size(); ++x) {
-					for (int y = 0; y < mg.size(); ++y) {
-						
-						if (mg.get_cell(x,y).possibilities() == i) {
-							
-							// for each possible value in a non-final cell
-							for(value_t v : mg.get_cell(x,y).get_values()) {
-								
-								// copy the current grid
-								Multiple_Value_Sudoku_Grid mg_assumption = mg;
-								
-								// remove the value
-								removed(mg_assumption.get_cell(x,y).get_values(), v);
-								
-								// call to solving algorithm for the copy (copies used values in sections implicitly)
-								_solve_ret_t ret = _solve(std::move(mg_assumption), boxes, lines_x, lines_y);
-								
-								// if the copied grid was solved sucessfully return the solution
-								if (ret.solved)
-									return ret;
-							}
-						}
-					}
-				}
+		Solve_Result result = engine.result();
+		result.stats.propagation_rounds += singles_stats.propagation_rounds;
+		result.stats.time += singles_stats.time;
+		return result;
+	}
+	
+	Solve_Result solve(const Single_Value_Sudoku_Grid& sg_start, Solution_Cache& cache,
+					   const Solve_Limits& limits, const Search_Options& options) {
+		
+		// the cache holds one solution per grid, not their amount
+		if (options.solution_limit != 1)
+			return solve(sg_start, Grid_Layout::standard(sg_start.size()), limits, options);
+		
+		// equivalent grids mostly share the same cache entry (see symmetry_key)
+		Symmetry_Key key = symmetry_key(sg_start);
+		
+		if (const Multiple_Value_Sudoku_Grid* cached = cache.find(key.grid))
+			return {apply_inverse(key.transform, *cached), Solve_Status::solved, "solved (cached)", {}};
+		
+		Solve_Result ret = solve(key.grid, Grid_Layout::standard(key.grid.size()), limits, options);
+		
+		// only solutions are cached
+		if (ret.status == Solve_Status::solved)
+			cache.insert(key.grid, ret.grid);
+		
+		ret.grid = apply_inverse(key.transform, ret.grid);
+		return ret;
+	}
+	
+	const char* to_string(Solve_Status status) {
+		switch (status) {
+			case Solve_Status::solved: return "solved";
+			case Solve_Status::contradiction: return "contradiction";
+			case Solve_Status::timeout: return "timeout";
+			case Solve_Status::assumption_limit: return "assumption limit reached";
+			case Solve_Status::memory_limit: return "memory limit reached";
+			case Solve_Status::cancelled: return "cancelled";
+		}
+		return "unknown";
+	}
+	
+	const char* to_string(Branching branching) {
+		switch (branching) {
+			case Branching::scan: return "scan";
+			case Branching::random: return "random";
+			case Branching::degree: return "degree";
+			case Branching::constraint: return "constraint";
+		}
+		return "unknown";
+	}
+	
+	bool parse_branching(const std::string& name, Branching& branching) {
+		for (Branching b : {Branching::scan, Branching::random, Branching::degree, Branching::constraint}) {
+			if (name == to_string(b)) {
+				branching = b;
+				return true;
 			}
-			
-			// contradiction: checked all possibilities and found no solution
-			return {std::move(mg), false, "no possibility left"};
-			
-		} else	{
-			// the grid is solved (all cells are final)
-			return {std::move(mg), true, "solved"};
 		}
+		return false;
 	}
-
+	
+	const char* to_string(Backend backend) {
+		switch (backend) {
+			case Backend::search: return "search";
+			case Backend::sat: return "sat";
+		}
+		return "unknown";
+	}
+	
+	bool parse_backend(const std::string& name, Backend& backend) {
+		for (Backend b : {Backend::search, Backend::sat}) {
+			if (name == to_string(b)) {
+				backend = b;
+				return true;
+			}
+		}
+		return false;
+	}
+	
 	//! set the values of cell to all values between 1 and max_value except the current values
 	Multiple_Value_Cell invert(const Single_Value_Cell& rhs, value_t max_value) {
 		
@@ -9,13 +9,151 @@
 #ifndef solve_h
 #define solve_h
 
+#include <atomic>
+#include <chrono>
+#include <string>
 #include "SudokuGrid.h"
+#include "SolutionCache.h"
+#include "Layout.h"
 
 namespace sudoku_solver {
 	
+	//! outcome of a solving attempt
+	enum class Solve_Status {solved, contradiction, timeout, assumption_limit, memory_limit, cancelled};
+	
+	//! flag to stop a running solving attempt from another thread
+	class Cancellation_Token {
+		
+	public:
+		void cancel() {_cancelled.store(true, std::memory_order_relaxed);}
+		void reset() {_cancelled.store(false, std::memory_order_relaxed);}
+		bool cancelled() const {return _cancelled.load(std::memory_order_relaxed);}
+		
+	private:
+		std::atomic<bool> _cancelled {false};
+	};
+	
+	//! limits of a single solving attempt (zero means unlimited)
+	struct Solve_Limits {
+		//! wall-clock time
+		std::chrono::milliseconds time {0};
+		//! amount of assumptions made in step II
+		unsigned long assumptions = 0;
+		//! estimated amount of bytes used by the grids of all recursion levels
+		std::size_t memory = 0;
+		//! optional token which stops the attempt once cancelled
+		const Cancellation_Token* cancellation = nullptr;
+	};
+	
+	//! statistics of a (possibly interrupted) solving attempt
+	struct Solve_Stats {
+		unsigned long assumptions = 0;
+		unsigned long propagation_rounds = 0;
+		unsigned int max_depth = 0;
+		std::size_t peak_memory = 0;
+		std::chrono::microseconds time {0};
+		//! nogoods stored resp. values finalized due to stored nogoods (see Search_Options)
+		unsigned long learned_nogoods = 0;
+		unsigned long nogood_implications = 0;
+		//! grids pruned because they were already refuted (see Search_Options)
+		unsigned long transposition_hits = 0;
+		//! amount of times the search started over at the top level (see Search_Options)
+		unsigned long restarts = 0;
+		//! amount of solutions found (see Search_Options)
+		unsigned long solutions = 0;
+	};
+	
+	class Search_Tracer;
+
+	//! order in which step II makes its assumptions
+	enum class Branching {
+		//! cells with fewer possibilities first, then in scan order (x, then y), values in ascending order
+		scan,
+		//! like scan but cells with the same amount of possibilities and the values in random order
+		random,
+		//! like scan but among cells with the same amount of possibilities the one with most non-final peers first
+		degree,
+		//! values which are possible in the fewest cells of a unit (or cells with the fewest values) first
+		//! (the column choice of dancing links)
+		constraint
+	};
+
+	//! engine which solves a grid
+	enum class Backend {
+		//! constraint propagation (step I) and assumptions (step II) by Search_Engine
+		search,
+		//! CDCL on the CNF encoding of the grid (see solve_sat), scales better to grids of 36x36 and larger
+		sat
+	};
+
+	//! optional techniques for step II
+	struct Search_Options {
+		//! Contradicting assumptions are analyzed: the removed value is the only one left for its cell
+		//! under the active assumptions. Such nogoods with up to nogood_size assumptions are stored
+		//! (at most nogood_capacity, zero disables the analysis) and checked in all later branches.
+		std::size_t nogood_capacity = 0;
+		unsigned int nogood_size = 8;
+		//! Grids reached by different orders of assumptions are recognized by a hash of their possible values.
+		//! The hashes of refuted grids are stored in a table of at most transposition_memory bytes
+		//! (zero disables the table) and such grids are pruned right after step I.
+		std::size_t transposition_memory = 0;
+		//! order of the assumptions and seed of the random order
+		Branching branching = Branching::scan;
+		std::uint64_t seed = 0;
+		//! The search starts over after restart_interval times the next element of the Luby sequence
+		//! (1, 1, 2, 1, 1, 2, 4, ...) assumptions (zero disables restarts). With random branching
+		//! each restart uses a different order; learned nogoods and refuted grids are kept.
+		unsigned long restart_interval = 0;
+		//! The search ends after this amount of solutions (zero counts all solutions, restarts are disabled
+		//! if it is not one). The result contains the first solution and the statistics the amount found.
+		unsigned long solution_limit = 1;
+		//! optional tracer which records each assumption and how it ended (must outlive the search)
+		Search_Tracer* tracer = nullptr;
+		//! engine used by solve (the techniques above except the solution limit apply to Backend::search only)
+		Backend backend = Backend::search;
+	};
+	
+	//! result of a solving attempt
+	struct Solve_Result {
+		//! solved grid or the grid in the state in which the attempt ended
+		Multiple_Value_Sudoku_Grid grid;
+		Solve_Status status = Solve_Status::contradiction;
+		//! either 'solved', a contradiction message (e.g. 'same value in box') or the reason of an interruption
+		std::string reason;
+		Solve_Stats stats;
+	};
+	
 	//! tries to slove the given sudoku
 	//! @return either the solved sudoku or a sudoku gird in a state in which the algorith detected a contradiction
 	Multiple_Value_Sudoku_Grid solve(const Single_Value_Sudoku_Grid& sg_start);
+	
+	//! tries to slove the given sudoku within the given limits
+	Solve_Result solve(const Single_Value_Sudoku_Grid& sg_start, const Solve_Limits& limits);
+	
+	//! tries to slove the given variant sudoku (e.g. jigsaw or diagonal) within the given limits
+	Solve_Result solve(const Single_Value_Sudoku_Grid& sg_start, const Grid_Layout& layout,
+					   const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options());
+	
+	//! tries to solve the given sudoku via its symmetry key and looks up resp. stores the solution in the cache
+	Solve_Result solve(const Single_Value_Sudoku_Grid& sg_start, Solution_Cache& cache,
+					   const Solve_Limits& limits = Solve_Limits(), const Search_Options& options = Search_Options());
+	
+	//! converts the multiple valued grid into a single valued grid
+	//! with all empty cells filled with all possible (1 to max_value) values
+	Multiple_Value_Sudoku_Grid create_possibility_grid(const Single_Value_Sudoku_Grid& rhs);
+	
+	//! @return short description of the status
+	const char* to_string(Solve_Status status);
+
+	//! @return name of the branching order (as used on the command line)
+	const char* to_string(Branching branching);
+	//! @return false if the name is unknown
+	bool parse_branching(const std::string& name, Branching& branching);
+
+	//! @return name of the backend (as used on the command line)
+	const char* to_string(Backend backend);
+	//! @return false if the name is unknown
+	bool parse_backend(const std::string& name, Backend& backend);
 }
 
 #endif /* solve_h */
@@ -49,4 +49,18 @@ inline void remove(std::vector<V>& c, const V& v) {
 	removed(c, v);
 }
 
+//! @return i-th element of the Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, ...) starting at 1
+inline unsigned long luby(unsigned long i) {
+	unsigned long k = 1;
+	while (((1ul << k) - 1) < i)
+		++k;
+	while (i != (1ul << k) - 1) {
+		i -= (1ul << (k - 1)) - 1;
+		k = 1;
+		while (((1ul << k) - 1) < i)
+			++k;
+	}
+	return 1ul << (k - 1);
+}
+
 #endif /* util_h */